@@ -6,6 +6,20 @@
 //! 3. `bench_event_throughput()` - Events per second under rapid changes
 //! 4. `bench_idle_memory()` - Memory consumption in background
 //! 5. `bench_cpu_idle()` - CPU usage when idle
+//! 6. `bench_idle_wakeups()` - Poll wakeups per minute when idle
+//! 7. `bench_mock_backend()` - The same paths against `MockBackend`,
+//!    reproducible without a running media player
+//! 8. `bench_allocations()` - Heap allocations per control call, with
+//!    static and dynamic dispatch, and per metadata event fanned out
+//! 9. `bench_artwork_thumbnail()` - Cost of decoding and scaling artwork,
+//!    and of `current()` with a cached thumbnail
+//! 10. `bench_startup()` - Time to create `MediaSessions`, blocking and
+//!     async, for the first instance and with one already alive
+//! 11. `bench_active_app_contention()` - Latency of `active_app()` while
+//!     other threads read it and players come and go
+//! 12. `bench_mpris()` - The Linux backend end to end, against a fake MPRIS
+//!     player on a private `dbus-daemon`, including the `GetAll` read after
+//!     a track change and its round trips; Linux with `mock-mpris` only
 //!
 //! # Running Benchmarks
 //!
@@ -13,13 +27,54 @@
 //! cargo bench --bench media_sessions
 //! ```
 
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::cell::Cell;
+use std::sync::Arc;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::thread::{self, JoinHandle};
 use std::time::{Duration, Instant};
 
 use criterion::{BenchmarkId, Criterion, Throughput, criterion_group, criterion_main};
 use futures::StreamExt;
-use media_sessions::MediaSessions;
+use media_sessions::platform::MockBackend;
+use media_sessions::polling::{PollConfig, PollScheduler, PollState};
+use media_sessions::{
+    ArtworkId, MediaInfo, MediaSessionEvent, MediaSessions, MediaSessionsBuilder, PlaybackStatus,
+};
 use tokio::runtime::Runtime;
 
+thread_local! {
+    /// Heap allocations made by the current thread.
+    static THREAD_ALLOCATIONS: Cell<u64> = const { Cell::new(0) };
+}
+
+/// System allocator that counts allocations per thread.
+struct CountingAllocator;
+
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        THREAD_ALLOCATIONS.with(|count| count.set(count.get() + 1));
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout);
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        THREAD_ALLOCATIONS.with(|count| count.set(count.get() + 1));
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static ALLOCATOR: CountingAllocator = CountingAllocator;
+
+/// Returns the allocations made by the current thread so far.
+fn thread_allocations() -> u64 {
+    THREAD_ALLOCATIONS.with(Cell::get)
+}
+
 /// Benchmark the latency of MediaSessions::current() call.
 fn bench_current(c: &mut Criterion) {
     let rt = Runtime::new().unwrap();
@@ -220,6 +275,509 @@ fn bench_cpu_idle(c: &mut Criterion) {
     group.finish();
 }
 
+/// Counts poll wakeups during one simulated minute without changes.
+///
+/// Reported as nanoseconds per iteration, one nanosecond per wakeup. The
+/// previous fixed 500ms poll loop made 120 wakeups per minute.
+fn bench_idle_wakeups(c: &mut Criterion) {
+    let mut group = c.benchmark_group("idle_wakeups");
+    group.sample_size(10);
+
+    for (name, state) in [
+        ("no_session", PollState::NoSession),
+        ("paused", PollState::Paused),
+    ] {
+        group.bench_function(BenchmarkId::new("wakeups_per_minute", name), |b| {
+            b.iter_custom(|iters| {
+                let mut total_wakeups = 0u64;
+
+                for _ in 0..iters {
+                    let mut scheduler = PollScheduler::new(PollConfig::default());
+                    let start = tokio::time::Instant::now();
+                    let end = start + Duration::from_secs(60);
+                    let mut now = start;
+
+                    while now < end {
+                        scheduler.observe(state, false);
+                        now += scheduler.interval(now);
+                        total_wakeups += 1;
+                    }
+                }
+
+                Duration::from_nanos(total_wakeups)
+            });
+        });
+    }
+
+    group.finish();
+}
+
+/// Creates a mocked player and a builder for it, so results do not depend
+/// on the machine's media players.
+fn mock_builder(rt: &Runtime) -> (MockBackend, MediaSessionsBuilder) {
+    let mock = MockBackend::new().session(
+        "bench",
+        MediaInfo {
+            title: Some("Track".into()),
+            ..MediaInfo::default()
+        },
+    );
+    let builder = MediaSessions::builder()
+        .runtime(rt.handle().clone())
+        .enable_artwork(false)
+        .debounce_duration(Duration::from_millis(1));
+    (mock, builder)
+}
+
+/// Creates `MediaSessions` on a mocked player behind the type-erased backend.
+fn mock_sessions(rt: &Runtime) -> (MockBackend, MediaSessions) {
+    let (mock, builder) = mock_builder(rt);
+    let sessions = builder.backend(mock.clone()).build().unwrap();
+    (mock, sessions)
+}
+
+/// Creates `MediaSessions` that call the mocked player statically.
+fn static_mock_sessions(rt: &Runtime) -> MediaSessions<MockBackend> {
+    let (mock, builder) = mock_builder(rt);
+    builder.build_with(mock).unwrap()
+}
+
+/// Benchmark the crate's own overhead against a mocked player.
+fn bench_mock_backend(c: &mut Criterion) {
+    let rt = Runtime::new().unwrap();
+
+    let mut group = c.benchmark_group("mock_backend");
+    group.sample_size(50);
+    group.measurement_time(Duration::from_secs(10));
+    group.warm_up_time(Duration::from_secs(3));
+
+    group.bench_function("current_latency", |b| {
+        let (_mock, sessions) = mock_sessions(&rt);
+        b.to_async(&rt).iter(|| sessions.current());
+    });
+
+    group.bench_function("play_latency", |b| {
+        let (_mock, sessions) = mock_sessions(&rt);
+        b.to_async(&rt).iter(|| sessions.play());
+    });
+
+    group.bench_function("play_latency_static", |b| {
+        let sessions = static_mock_sessions(&rt);
+        b.to_async(&rt).iter(|| sessions.play());
+    });
+
+    group.bench_function("event_latency", |b| {
+        let (mock, sessions) = mock_sessions(&rt);
+        let mut stream = rt.block_on(sessions.watch()).unwrap();
+        let mut status = PlaybackStatus::Playing;
+
+        b.iter_custom(|iters| {
+            let mut total = Duration::ZERO;
+
+            for _ in 0..iters {
+                status = if status.is_playing() {
+                    PlaybackStatus::Paused
+                } else {
+                    PlaybackStatus::Playing
+                };
+                let next = MediaInfo {
+                    title: Some("Track".into()),
+                    playback_status: status,
+                    ..MediaInfo::default()
+                };
+
+                // Stay clear of the debounce window.
+                std::thread::sleep(Duration::from_millis(2));
+                let start = Instant::now();
+                mock.set_state(Some(next));
+                rt.block_on(async {
+                    while let Some(Ok(event)) = stream.next().await {
+                        if event == MediaSessionEvent::PlaybackStatusChanged(status) {
+                            break;
+                        }
+                    }
+                });
+                total += start.elapsed();
+            }
+
+            total
+        });
+    });
+
+    group.finish();
+}
+
+/// Counts heap allocations per `play()` against a mocked player, and per
+/// copy of a metadata event handed to a subscriber.
+///
+/// Reported as nanoseconds per iteration, one nanosecond per allocation.
+/// Everything runs on the bench thread, so only the call itself is
+/// counted. With static dispatch a control call makes no allocation.
+fn bench_allocations(c: &mut Criterion) {
+    let rt = tokio::runtime::Builder::new_current_thread()
+        .enable_all()
+        .build()
+        .unwrap();
+
+    let mut group = c.benchmark_group("allocations_per_call");
+    group.sample_size(10);
+
+    let (_mock, dynamic) = mock_sessions(&rt);
+    let statically = static_mock_sessions(&rt);
+
+    group.bench_function(BenchmarkId::new("play", "dyn_dispatch"), |b| {
+        b.iter_custom(|iters| {
+            rt.block_on(async {
+                let before = thread_allocations();
+                for _ in 0..iters {
+                    dynamic.play().await.unwrap();
+                }
+                Duration::from_nanos(thread_allocations() - before)
+            })
+        });
+    });
+
+    group.bench_function(BenchmarkId::new("play", "static_dispatch"), |b| {
+        b.iter_custom(|iters| {
+            rt.block_on(async {
+                let before = thread_allocations();
+                for _ in 0..iters {
+                    statically.play().await.unwrap();
+                }
+                Duration::from_nanos(thread_allocations() - before)
+            })
+        });
+    });
+
+    // Every subscriber of `watch()` gets its own copy of a metadata event.
+    // The strings are shared and artwork is an id, so a copy makes no
+    // allocation.
+    let event = MediaSessionEvent::MetadataChanged(MediaInfo {
+        title: Some("Track".into()),
+        artist: Some("Artist".into()),
+        album: Some("Album".into()),
+        genre: Some("Genre".into()),
+        url: Some("file:///music/track.flac".into()),
+        thumbnail_url: Some("file:///music/cover.jpg".into()),
+        artwork: Some(ArtworkId::of(&[0; 64 * 1024])),
+        ..MediaInfo::default()
+    });
+    group.bench_function(BenchmarkId::new("metadata_event", "fan_out"), |b| {
+        b.iter_custom(|iters| {
+            let before = thread_allocations();
+            for _ in 0..iters {
+                std::hint::black_box(event.clone());
+            }
+            Duration::from_nanos(thread_allocations() - before)
+        });
+    });
+
+    group.finish();
+}
+
+/// Encodes a `size` × `size` JPEG, about the size of album art.
+fn jpeg_cover(size: u32) -> Vec<u8> {
+    let cover = image::RgbImage::from_fn(size, size, |x, y| {
+        image::Rgb([x as u8, y as u8, (x ^ y) as u8])
+    });
+    let mut jpeg = std::io::Cursor::new(Vec::new());
+    image::DynamicImage::from(cover)
+        .write_to(&mut jpeg, image::ImageFormat::Jpeg)
+        .unwrap();
+    jpeg.into_inner()
+}
+
+/// Benchmark artwork decoding and downscaling.
+fn bench_artwork_thumbnail(c: &mut Criterion) {
+    let rt = Runtime::new().unwrap();
+    let cover = jpeg_cover(1200);
+
+    let mut group = c.benchmark_group("artwork_thumbnail");
+    group.sample_size(20);
+    group.throughput(Throughput::Bytes(cover.len() as u64));
+
+    group.bench_function("decode_1200px_jpeg", |b| {
+        b.iter(|| image::load_from_memory(&cover).unwrap());
+    });
+
+    for size in [64, 300] {
+        group.bench_with_input(
+            BenchmarkId::new("downscale_1200px_jpeg", size),
+            &size,
+            |b, &size| {
+                b.iter(|| media_sessions::artwork::downscale(&cover, size, size).unwrap());
+            },
+        );
+    }
+
+    group.bench_function("current_cached_300px", |b| {
+        let (mock, builder) = mock_builder(&rt);
+        let sessions = builder
+            .backend(mock.artwork(cover.clone()))
+            .enable_artwork(true)
+            .artwork_max_size(300, 300)
+            .build()
+            .unwrap();
+        b.to_async(&rt).iter(|| sessions.current());
+    });
+
+    group.finish();
+}
+
+/// Benchmark creating `MediaSessions` on the current platform.
+///
+/// `first` drops every instance, so each one connects from scratch;
+/// `second` keeps one alive, so backends that share their connection reuse
+/// it. Iterations where no backend is available are not timed.
+fn bench_startup(c: &mut Criterion) {
+    let rt = Runtime::new().unwrap();
+
+    let mut group = c.benchmark_group("startup_latency");
+    group.sample_size(20);
+
+    for (name, keep_alive) in [("first", false), ("second", true)] {
+        let _alive = keep_alive.then(|| rt.block_on(MediaSessions::new_async()).ok());
+
+        group.bench_function(BenchmarkId::new("new", name), |b| {
+            b.iter_custom(|iters| {
+                let mut total = Duration::ZERO;
+                for _ in 0..iters {
+                    let start = Instant::now();
+                    let sessions = MediaSessions::new();
+                    if sessions.is_ok() {
+                        total += start.elapsed();
+                    }
+                }
+                total
+            });
+        });
+
+        group.bench_function(BenchmarkId::new("new_async", name), |b| {
+            b.iter_custom(|iters| {
+                rt.block_on(async {
+                    let mut total = Duration::ZERO;
+                    for _ in 0..iters {
+                        let start = Instant::now();
+                        let sessions = MediaSessions::new_async().await;
+                        if sessions.is_ok() {
+                            total += start.elapsed();
+                        }
+                    }
+                    total
+                })
+            });
+        });
+    }
+
+    group.finish();
+}
+
+/// Name claimed and released to make players come and go.
+#[cfg(all(target_os = "linux", feature = "linux"))]
+const CHURN_PLAYER: &str = "org.mpris.MediaPlayer2.bench_contention";
+
+/// Makes players come and go until `stop` is set.
+///
+/// A second connection claims and releases an MPRIS name, so the backend's
+/// signal task keeps replacing the active player under the readers.
+#[cfg(all(target_os = "linux", feature = "linux"))]
+fn discovery_churn(stop: Arc<AtomicBool>) -> Option<JoinHandle<()>> {
+    Some(thread::spawn(move || {
+        futures::executor::block_on(async {
+            let Ok(connection) = zbus::Connection::session().await else {
+                return;
+            };
+            while !stop.load(Ordering::Relaxed) {
+                let _ = connection.request_name(CHURN_PLAYER).await;
+                let _ = connection.release_name(CHURN_PLAYER).await;
+            }
+        });
+    }))
+}
+
+/// Makes players come and go until `stop` is set; not available on this
+/// platform, so only readers contend.
+#[cfg(not(all(target_os = "linux", feature = "linux")))]
+fn discovery_churn(_stop: Arc<AtomicBool>) -> Option<JoinHandle<()>> {
+    None
+}
+
+/// Benchmark `active_app()` on the current platform while other threads
+/// read it too and, where possible, players are discovered and lost.
+fn bench_active_app_contention(c: &mut Criterion) {
+    let rt = Runtime::new().unwrap();
+    let Ok(sessions) = rt.block_on(MediaSessions::new_async()) else {
+        return;
+    };
+
+    let mut group = c.benchmark_group("active_app_contention");
+    group.sample_size(50);
+
+    for readers in [1, 4, 8] {
+        let stop = Arc::new(AtomicBool::new(false));
+        let mut workers: Vec<_> = (1..readers)
+            .map(|_| {
+                let sessions = sessions.clone();
+                let stop = Arc::clone(&stop);
+                thread::spawn(move || {
+                    while !stop.load(Ordering::Relaxed) {
+                        let _ = futures::executor::block_on(sessions.active_app());
+                    }
+                })
+            })
+            .collect();
+        workers.extend(discovery_churn(Arc::clone(&stop)));
+
+        group.bench_function(BenchmarkId::new("readers", readers), |b| {
+            b.iter(|| futures::executor::block_on(sessions.active_app()));
+        });
+
+        stop.store(true, Ordering::Relaxed);
+        for worker in workers {
+            worker.join().unwrap();
+        }
+    }
+
+    group.finish();
+}
+
+/// Benchmark the Linux backend against a fake MPRIS player on a private
+/// bus: cached reads, command round trips, and the time from a player
+/// signal to the event it turns into. Needs the `mock-mpris` feature.
+#[cfg(all(target_os = "linux", feature = "mock-mpris"))]
+fn bench_mpris(c: &mut Criterion) {
+    use media_sessions::platform::mock_mpris::{MockMprisPlayer, MockSessionBus};
+
+    let rt = Runtime::new().unwrap();
+    let Ok(bus) = MockSessionBus::start() else {
+        return;
+    };
+    let track = |title: &str| MediaInfo {
+        title: Some(title.into()),
+        artist: Some("Artist".into()),
+        duration: Some(Duration::from_secs(240)),
+        playback_status: PlaybackStatus::Paused,
+        ..MediaInfo::default()
+    };
+    let (player, sessions) = rt.block_on(async {
+        let player = bus.spawn_player("bench", track("Track")).await.unwrap();
+        let backend = bus.backend(rt.handle().clone()).await.unwrap();
+        let sessions = MediaSessions::builder()
+            .debounce_duration(Duration::from_millis(1))
+            .enable_artwork(false)
+            .build_with(backend)
+            .unwrap();
+        (player, sessions)
+    });
+
+    let mut group = c.benchmark_group("mpris");
+    group.sample_size(50);
+
+    group.bench_function("current", |b| {
+        b.to_async(&rt).iter(|| sessions.current());
+    });
+
+    group.bench_function("play_pause", |b| {
+        b.to_async(&rt).iter(|| sessions.play_pause());
+    });
+
+    group.bench_function("set_volume", |b| {
+        let mut volume = 0.0;
+        b.to_async(&rt).iter(|| {
+            volume = if volume > 0.5 { 0.25 } else { 0.75 };
+            sessions.set_volume(volume)
+        });
+    });
+
+    group.bench_function("metadata_event", |b| {
+        b.iter_custom(|iters| {
+            rt.block_on(async {
+                let mut stream = Box::pin(sessions.watch().await.unwrap());
+                let mut total = Duration::ZERO;
+                for i in 0..iters {
+                    let start = Instant::now();
+                    player
+                        .set_metadata(track(&format!("Track {i}")))
+                        .await
+                        .unwrap();
+                    while let Some(event) = stream.next().await {
+                        if matches!(event, Ok(MediaSessionEvent::MetadataChanged(_))) {
+                            break;
+                        }
+                    }
+                    total += start.elapsed();
+                }
+                total
+            })
+        });
+    });
+
+    /// Changes track and waits until `events` reports it. A track change
+    /// leaves the registry out of sync, so the next `current()` reads the
+    /// player in full.
+    async fn change_track<S>(player: &MockMprisPlayer, events: &mut S, track: MediaInfo)
+    where
+        S: futures::Stream<Item = media_sessions::MediaResult<MediaSessionEvent>> + Unpin,
+    {
+        player.set_metadata(track).await.unwrap();
+        while let Some(event) = events.next().await {
+            if matches!(event, Ok(MediaSessionEvent::MetadataChanged(_))) {
+                break;
+            }
+        }
+    }
+
+    group.bench_function("current_after_track_change", |b| {
+        b.iter_custom(|iters| {
+            rt.block_on(async {
+                let mut stream = Box::pin(sessions.watch().await.unwrap());
+                let mut total = Duration::ZERO;
+                for i in 0..iters {
+                    change_track(&player, &mut stream, track(&format!("Next {i}"))).await;
+                    let start = Instant::now();
+                    sessions.current().await.unwrap();
+                    total += start.elapsed();
+                }
+                total
+            })
+        });
+    });
+
+    group.finish();
+
+    // Property round trips per full read, one nanosecond per `Get` or
+    // `GetAll` call the player answered: one `GetAll`, where separate
+    // reads of `Metadata`, `PlaybackStatus` and `Position` took three.
+    let mut group = c.benchmark_group("mpris_round_trips");
+    group.sample_size(10);
+    let reads = || player.calls("Get") + player.calls("GetAll");
+    group.bench_function("current_after_track_change", |b| {
+        b.iter_custom(|iters| {
+            rt.block_on(async {
+                let mut stream = Box::pin(sessions.watch().await.unwrap());
+                let mut total = 0;
+                for i in 0..iters {
+                    change_track(&player, &mut stream, track(&format!("Next {i}"))).await;
+                    // Reads are counted off the call path; let them settle.
+                    tokio::time::sleep(Duration::from_millis(5)).await;
+                    let before = reads();
+                    sessions.current().await.unwrap();
+                    tokio::time::sleep(Duration::from_millis(5)).await;
+                    total += reads() - before;
+                }
+                Duration::from_nanos(total)
+            })
+        });
+    });
+
+    group.finish();
+}
+
+/// Benchmark the Linux backend against a fake MPRIS player; not available
+/// on this platform.
+#[cfg(not(all(target_os = "linux", feature = "mock-mpris")))]
+fn bench_mpris(_c: &mut Criterion) {}
+
 /// Benchmark playback control operations.
 fn bench_playback_controls(c: &mut Criterion) {
     let rt = Runtime::new().unwrap();
@@ -277,6 +835,13 @@ criterion_group!(
     bench_event_throughput,
     bench_idle_memory,
     bench_cpu_idle,
+    bench_idle_wakeups,
+    bench_mock_backend,
+    bench_allocations,
+    bench_artwork_thumbnail,
+    bench_startup,
+    bench_active_app_contention,
+    bench_mpris,
     bench_playback_controls,
 );
 
@@ -68,7 +68,8 @@ typedef enum {
     MEDIA_RESULT_NO_SESSION = 2,
     MEDIA_RESULT_NOT_SUPPORTED = 3,
     MEDIA_RESULT_TIMEOUT = 4,
-    MEDIA_RESULT_INVALID_ARG = 5
+    MEDIA_RESULT_INVALID_ARG = 5,
+    MEDIA_RESULT_CIRCUIT_OPEN = 6
 } MediaResult;
 
 /**
@@ -124,6 +125,43 @@ typedef struct {
     char* thumbnail_url;      /**< Thumbnail URL */
 } CMediaInfo;
 
+/**
+ * @brief Number of entries in CMetrics.operations
+ */
+#define MEDIA_SESSIONS_OPERATION_COUNT 13
+
+/**
+ * @brief Metrics of one backend operation (latencies in microseconds)
+ */
+typedef struct {
+    const char* name;         /**< Operation name (static, do not free) */
+    uint64_t calls;           /**< Backend attempts, including retries */
+    uint64_t errors;          /**< Failed attempts, including timeouts */
+    uint64_t timeouts;        /**< Attempts that hit the operation timeout */
+    uint64_t p50_us;          /**< Median latency */
+    uint64_t p90_us;          /**< 90th percentile latency */
+    uint64_t p99_us;          /**< 99th percentile latency */
+    uint64_t max_us;          /**< Largest latency */
+    uint64_t mean_us;         /**< Mean latency */
+} COperationMetrics;
+
+/**
+ * @brief Metrics snapshot
+ */
+typedef struct {
+    uint64_t backend_calls;    /**< Backend method invocations, IPC or not */
+    uint64_t events_emitted;   /**< Events emitted to watch streams */
+    uint64_t events_coalesced; /**< Changes merged into a pending event batch */
+    uint64_t updates_dropped;  /**< Raw backend updates dropped under load */
+    uint64_t timeouts;         /**< Attempts that hit the operation timeout */
+    uint64_t poll_ticks;       /**< Scheduled polls */
+    uint64_t retries;          /**< Retries of idempotent calls */
+    uint64_t circuit_opens;    /**< Times a player's circuit opened */
+    uint64_t rejected;         /**< Calls failed fast by an open circuit */
+    uint64_t writes_combined;  /**< Setter calls superseded by a later value */
+    COperationMetrics operations[MEDIA_SESSIONS_OPERATION_COUNT]; /**< Per-operation metrics */
+} CMetrics;
+
 /**
  * @brief Event callback function type
  * @param event_type Type of event (MediaEventType)
@@ -155,6 +193,19 @@ media_sessions_c_new(void);
 MEDIA_SESSIONS_API MediaSessionsHandle* MEDIA_SESSIONS_CALL 
 media_sessions_c_new_with_debounce(uint64_t debounce_ms);
 
+/**
+ * @brief Create a new MediaSessions instance that combines setter calls
+ *
+ * While a seek, volume, repeat or shuffle call is in flight, further calls
+ * of the same function from other threads wait, and only the latest of
+ * them is sent once it completes. The calls it replaced return
+ * MEDIA_RESULT_OK without reaching the player.
+ *
+ * @return Handle to MediaSessions, or NULL on error
+ */
+MEDIA_SESSIONS_API MediaSessionsHandle* MEDIA_SESSIONS_CALL 
+media_sessions_c_new_with_write_combining(void);
+
 /**
  * @brief Free a MediaSessions handle
  * @param handle Handle to free
@@ -194,6 +245,10 @@ media_sessions_c_free_artwork(uint8_t* data, size_t len);
 
 /**
  * @brief Get the active application name
+ *
+ * Answered from memory without blocking, so it is cheap to call from
+ * any thread.
+ *
  * @param handle MediaSessions handle
  * @return Application name (must be freed), or NULL on error
  */
@@ -261,6 +316,19 @@ media_sessions_c_previous(MediaSessionsHandle* handle);
 MEDIA_SESSIONS_API MediaResult MEDIA_SESSIONS_CALL 
 media_sessions_c_seek(MediaSessionsHandle* handle, uint64_t position_secs);
 
+/**
+ * @brief Move the playback position relative to the current one
+ *
+ * Where the platform supports it, this is a single call to the player,
+ * without reading the position first.
+ *
+ * @param handle MediaSessions handle
+ * @param offset_ms Offset in milliseconds, backwards if negative
+ * @return MediaResult code
+ */
+MEDIA_SESSIONS_API MediaResult MEDIA_SESSIONS_CALL 
+media_sessions_c_seek_by_ms(MediaSessionsHandle* handle, int64_t offset_ms);
+
 /* ============================================================================
  * Extended control functions
  * ============================================================================ */
@@ -310,6 +378,15 @@ media_sessions_c_version(void);
 MEDIA_SESSIONS_API const char* MEDIA_SESSIONS_CALL 
 media_sessions_c_platform(void);
 
+/**
+ * @brief Get a snapshot of the metrics of a handle
+ * @param handle MediaSessions handle
+ * @param out Metrics to fill (holds no allocations, nothing to free)
+ * @return MediaResult code
+ */
+MEDIA_SESSIONS_API MediaResult MEDIA_SESSIONS_CALL 
+media_sessions_c_get_metrics(MediaSessionsHandle* handle, CMetrics* out);
+
 /* ============================================================================
  * Event callback functions (future implementation)
  * ============================================================================ */
@@ -94,7 +94,7 @@ async fn main() -> Result<(), Box<dyn std::error::Error>> {
             println!("🔊 Volume set to {:.0}%", volume * 100.0);
         }
         "watch" | "events" => {
-            cmd_watch(&sessions)?;
+            cmd_watch(&sessions).await?;
         }
         "help" | "--help" | "-h" => {
             print_help();
@@ -180,43 +180,38 @@ async fn cmd_active(sessions: &MediaSessions) -> Result<(), Box<dyn std::error::
     Ok(())
 }
 
-fn cmd_watch(sessions: &MediaSessions) -> Result<(), Box<dyn std::error::Error>> {
+async fn cmd_watch(sessions: &MediaSessions) -> Result<(), Box<dyn std::error::Error>> {
     use futures::StreamExt;
 
     println!("📡 Watching for media events... (Press Ctrl+C to stop)");
 
-    let rt = tokio::runtime::Runtime::new()?;
-    rt.block_on(async {
-        let mut stream = sessions.watch().await?;
+    let mut stream = sessions.watch().await?;
 
-        while let Some(event) = stream.next().await {
-            match event? {
-                MediaSessionEvent::MetadataChanged(info) => {
-                    println!("\n🎵 Metadata changed:");
-                    if info.title().is_empty() && info.artist().is_empty() {
-                        println!("   <no metadata>");
-                    } else {
-                        println!("   {}", info.display_string());
-                    }
+    while let Some(event) = stream.next().await {
+        match event? {
+            MediaSessionEvent::MetadataChanged(info) => {
+                println!("\n🎵 Metadata changed:");
+                if info.title().is_empty() && info.artist().is_empty() {
+                    println!("   <no metadata>");
+                } else {
+                    println!("   {}", info.display_string());
                 }
-                MediaSessionEvent::PlaybackStatusChanged(status) => {
-                    println!("\n▶️ Status: {}", status);
-                }
-                MediaSessionEvent::PositionChanged { position, .. } => {
-                    println!("\n⏱ Position: {}", format_duration(position));
-                }
-                MediaSessionEvent::SessionOpened { app_name } => {
-                    println!("\n📻 Session opened: {}", app_name);
-                }
-                MediaSessionEvent::SessionClosed => {
-                    println!("\n📻 Session closed");
-                }
-                _ => {}
             }
+            MediaSessionEvent::PlaybackStatusChanged(status) => {
+                println!("\n▶️ Status: {}", status);
+            }
+            MediaSessionEvent::PositionChanged { position, .. } => {
+                println!("\n⏱ Position: {}", format_duration(position));
+            }
+            MediaSessionEvent::SessionOpened { app_name } => {
+                println!("\n📻 Session opened: {}", app_name);
+            }
+            MediaSessionEvent::SessionClosed => {
+                println!("\n📻 Session closed");
+            }
+            _ => {}
         }
-
-        Ok::<_, Box<dyn std::error::Error>>(())
-    })?;
+    }
 
     Ok(())
 }
@@ -0,0 +1,336 @@
+//! Artwork storage and thumbnails.
+//!
+//! Artwork is not carried inside [`MediaInfo`](crate::MediaInfo). Each
+//! `MediaSessions` keeps the covers it has seen in a store keyed by a hash
+//! of their bytes, and [`MediaInfo::artwork`](crate::MediaInfo::artwork)
+//! holds only the [`ArtworkId`]. The bytes are fetched with
+//! [`MediaSessions::artwork`](crate::MediaSessions::artwork), so a cover
+//! that did not change between two `current()` calls is not copied again,
+//! and consumers that do not render artwork never touch it.
+//!
+//! The store keeps the least recently used covers up to
+//! [`MediaSessionsBuilder::artwork_cache_size`](crate::MediaSessionsBuilder::artwork_cache_size)
+//! bytes. With
+//! [`MediaSessionsBuilder::artwork_max_size`](crate::MediaSessionsBuilder::artwork_max_size),
+//! larger artwork is decoded and scaled down on the blocking thread pool
+//! before it is stored, so the same cover is only scaled once.
+//!
+//! Hashing a cover reads all of its bytes, so `current()` first asks the
+//! backend for a cheap key of the current artwork, such as the track and
+//! its file's modification time and size on Linux. While that key is unchanged, the
+//! id from the last call is reused and the artwork is neither fetched nor
+//! hashed; otherwise it is fetched and hashed on the blocking thread
+//! pool.
+
+use std::fmt;
+use std::hash::{DefaultHasher, Hash, Hasher};
+use std::io::Cursor;
+use std::sync::{Arc, Mutex, PoisonError};
+
+use image::{DynamicImage, ImageFormat};
+
+/// Default total size of the artwork kept in the store.
+pub(crate) const DEFAULT_STORE_BUDGET: usize = 8 * 1024 * 1024;
+
+/// Bytes charged per store entry on top of the artwork itself.
+const ENTRY_OVERHEAD: usize = 64;
+
+/// Identifies a cover by a hash of the bytes the player provides.
+///
+/// Equal ids mean equal covers, so a consumer only needs to fetch the bytes
+/// when the id in [`MediaInfo::artwork`](crate::MediaInfo::artwork)
+/// changes. Ids are stable within one process, not across builds.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+#[cfg_attr(feature = "serde", derive(serde::Serialize, serde::Deserialize))]
+pub struct ArtworkId(u64);
+
+impl ArtworkId {
+    /// Returns the id of the artwork `bytes`.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use media_sessions::ArtworkId;
+    ///
+    /// assert_eq!(ArtworkId::of(b"cover"), ArtworkId::of(b"cover"));
+    /// assert_ne!(ArtworkId::of(b"cover"), ArtworkId::of(b"other"));
+    /// ```
+    #[must_use]
+    pub fn of(bytes: &[u8]) -> Self {
+        let mut hasher = DefaultHasher::new();
+        bytes.hash(&mut hasher);
+        Self(hasher.finish())
+    }
+
+    /// Returns the hash as a number, e.g. for use as a file name.
+    #[must_use]
+    pub const fn as_u64(self) -> u64 {
+        self.0
+    }
+}
+
+impl fmt::Display for ArtworkId {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(f, "{:016x}", self.0)
+    }
+}
+
+/// Returns the image format of encoded artwork, if recognized.
+///
+/// # Examples
+///
+/// ```rust
+/// use media_sessions::artwork::format;
+///
+/// assert_eq!(format(&[0xFF, 0xD8, 0xFF, 0xE0]), Some("JPEG"));
+/// assert_eq!(format(b"not an image"), None);
+/// ```
+#[must_use]
+pub const fn format(bytes: &[u8]) -> Option<&'static str> {
+    match bytes {
+        [0x89, 0x50, 0x4E, 0x47, ..] => Some("PNG"),
+        [0xFF, 0xD8, 0xFF, ..] => Some("JPEG"),
+        [0x47, 0x49, 0x46, 0x38, ..] => Some("GIF"),
+        _ => None,
+    }
+}
+
+/// Scales encoded artwork down to fit within `max_width` × `max_height`,
+/// keeping its aspect ratio.
+///
+/// JPEG artwork is encoded as JPEG again, anything else as PNG. Returns
+/// `None` if the artwork already fits or cannot be decoded; the original
+/// bytes should then be used as they are. Decoding is CPU-bound, so call
+/// this on a blocking thread.
+///
+/// # Examples
+///
+/// ```rust
+/// use media_sessions::artwork::downscale;
+///
+/// // Not an image: nothing to scale.
+/// assert_eq!(downscale(b"not an image", 64, 64), None);
+/// ```
+#[must_use]
+pub fn downscale(bytes: &[u8], max_width: u32, max_height: u32) -> Option<Vec<u8>> {
+    let format = image::guess_format(bytes).ok()?;
+    let image = image::load_from_memory(bytes).ok()?;
+    if image.width() <= max_width && image.height() <= max_height {
+        return None;
+    }
+
+    let thumbnail = image.thumbnail(max_width, max_height);
+    let mut encoded = Cursor::new(Vec::new());
+    let written = if format == ImageFormat::Jpeg {
+        DynamicImage::from(thumbnail.to_rgb8()).write_to(&mut encoded, ImageFormat::Jpeg)
+    } else {
+        thumbnail.write_to(&mut encoded, ImageFormat::Png)
+    };
+    written.ok()?;
+    Some(encoded.into_inner())
+}
+
+/// A stored cover, possibly scaled down.
+#[derive(Debug)]
+struct Entry {
+    id: ArtworkId,
+    bytes: Arc<[u8]>,
+}
+
+impl Entry {
+    fn size(&self) -> usize {
+        ENTRY_OVERHEAD + self.bytes.len()
+    }
+}
+
+/// Artwork seen by one `MediaSessions`, shared by its clones.
+#[derive(Debug)]
+pub(crate) struct ArtworkStore {
+    budget: usize,
+    max_size: Option<(u32, u32)>,
+    /// Stored covers, least recently used first.
+    entries: Mutex<Vec<Entry>>,
+    /// The backend's last artwork key and the id of the artwork it stood
+    /// for, `None` if there was none.
+    last: Mutex<Option<(u64, Option<ArtworkId>)>>,
+}
+
+impl ArtworkStore {
+    /// Creates a store holding up to `budget` bytes of artwork, scaled
+    /// down to fit within `max_size` if set.
+    pub(crate) const fn new(budget: usize, max_size: Option<(u32, u32)>) -> Self {
+        Self {
+            budget,
+            max_size,
+            entries: Mutex::new(Vec::new()),
+            last: Mutex::new(None),
+        }
+    }
+
+    /// Returns the backend's artwork key and id passed to the last
+    /// [`remember`](Self::remember).
+    pub(crate) fn last(&self) -> Option<(u64, Option<ArtworkId>)> {
+        *self.last.lock().unwrap_or_else(PoisonError::into_inner)
+    }
+
+    /// Remembers that the backend's artwork `key` stands for `id`.
+    pub(crate) fn remember(&self, key: u64, id: Option<ArtworkId>) {
+        *self.last.lock().unwrap_or_else(PoisonError::into_inner) = Some((key, id));
+    }
+
+    /// Returns the stored artwork with `id`.
+    pub(crate) fn get(&self, id: ArtworkId) -> Option<Arc<[u8]>> {
+        let mut entries = self.entries.lock().unwrap_or_else(PoisonError::into_inner);
+        let index = entries.iter().position(|entry| entry.id == id)?;
+        let entry = entries.remove(index);
+        let bytes = Arc::clone(&entry.bytes);
+        entries.push(entry);
+        drop(entries);
+        Some(bytes)
+    }
+
+    /// Adds `source` as the player provides it and returns its id along
+    /// with the bytes handed out for it.
+    ///
+    /// Artwork that is already stored is neither scaled nor copied again.
+    /// Artwork larger than the whole budget is returned but not kept.
+    /// Hashing and scaling are CPU-bound, so call this on a blocking
+    /// thread.
+    pub(crate) fn insert(&self, source: Arc<[u8]>) -> (ArtworkId, Arc<[u8]>) {
+        let id = ArtworkId::of(&source);
+        if let Some(bytes) = self.get(id) {
+            return (id, bytes);
+        }
+
+        let bytes = self
+            .max_size
+            .and_then(|(width, height)| downscale(&source, width, height))
+            .map_or(source, Arc::from);
+        let entry = Entry {
+            id,
+            bytes: Arc::clone(&bytes),
+        };
+        if entry.size() <= self.budget {
+            let mut entries = self.entries.lock().unwrap_or_else(PoisonError::into_inner);
+            entries.retain(|stored| stored.id != id);
+            entries.push(entry);
+            let mut used: usize = entries.iter().map(Entry::size).sum();
+            while used > self.budget {
+                used -= entries.remove(0).size();
+            }
+            drop(entries);
+        }
+        (id, bytes)
+    }
+
+    /// Returns the number of stored covers.
+    #[cfg(test)]
+    fn len(&self) -> usize {
+        self.entries
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner)
+            .len()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use image::{Rgb, RgbImage};
+
+    fn png(width: u32, height: u32) -> Arc<[u8]> {
+        let image = RgbImage::from_fn(width, height, |x, y| {
+            Rgb([x.to_le_bytes()[0], y.to_le_bytes()[0], 128])
+        });
+        let mut bytes = Cursor::new(Vec::new());
+        DynamicImage::from(image)
+            .write_to(&mut bytes, ImageFormat::Png)
+            .unwrap();
+        bytes.into_inner().into()
+    }
+
+    #[test]
+    fn test_downscale_keeps_aspect_ratio() {
+        let thumbnail = downscale(&png(400, 200), 100, 100).unwrap();
+        let decoded = image::load_from_memory(&thumbnail).unwrap();
+        assert_eq!((decoded.width(), decoded.height()), (100, 50));
+        assert_eq!(image::guess_format(&thumbnail).unwrap(), ImageFormat::Png);
+    }
+
+    #[test]
+    fn test_format_detection() {
+        assert_eq!(format(&[0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A]), Some("PNG"));
+        assert_eq!(format(&[0xFF, 0xD8, 0xFF, 0xE0]), Some("JPEG"));
+        assert_eq!(format(b"GIF89a"), Some("GIF"));
+        assert_eq!(format(&[]), None);
+    }
+
+    #[test]
+    fn test_small_or_invalid_artwork_is_kept() {
+        assert_eq!(downscale(&png(64, 32), 100, 100), None);
+        assert_eq!(downscale(b"not an image", 100, 100), None);
+
+        let store = ArtworkStore::new(DEFAULT_STORE_BUDGET, Some((100, 100)));
+        let small = png(64, 32);
+        let (id, bytes) = store.insert(Arc::clone(&small));
+        assert_eq!(id, ArtworkId::of(&small));
+        assert!(Arc::ptr_eq(&bytes, &small));
+    }
+
+    #[test]
+    fn test_store_keys_thumbnails_by_source() {
+        let store = ArtworkStore::new(DEFAULT_STORE_BUDGET, Some((50, 50)));
+        let source = png(200, 200);
+        let (id, thumbnail) = store.insert(Arc::clone(&source));
+        assert_eq!(id, ArtworkId::of(&source));
+        assert!(thumbnail.len() < source.len());
+
+        // The same cover again is neither scaled nor copied.
+        let (again, bytes) = store.insert(source.to_vec().into());
+        assert_eq!(again, id);
+        assert!(Arc::ptr_eq(&bytes, &thumbnail));
+        assert!(Arc::ptr_eq(&store.get(id).unwrap(), &thumbnail));
+    }
+
+    #[test]
+    fn test_store_evicts_over_budget() {
+        let first = png(20, 20);
+        let second = png(30, 30);
+        let third = png(40, 40);
+        let size = second.len() + third.len() + 2 * ENTRY_OVERHEAD;
+        let store = ArtworkStore::new(size, None);
+
+        let (first_id, _) = store.insert(first);
+        let (second_id, _) = store.insert(second);
+        assert!(store.get(first_id).is_some());
+        let (third_id, _) = store.insert(third);
+        assert_eq!(store.len(), 2);
+
+        // `second` was the least recently used.
+        assert!(store.get(second_id).is_none());
+        assert!(store.get(first_id).is_some());
+        assert!(store.get(third_id).is_some());
+    }
+
+    #[test]
+    fn test_store_remembers_last_key() {
+        let store = ArtworkStore::new(DEFAULT_STORE_BUDGET, None);
+        assert_eq!(store.last(), None);
+
+        let id = ArtworkId::of(b"cover");
+        store.remember(1, Some(id));
+        assert_eq!(store.last(), Some((1, Some(id))));
+
+        store.remember(2, None);
+        assert_eq!(store.last(), Some((2, None)));
+    }
+
+    #[test]
+    fn test_oversized_artwork_is_not_kept() {
+        let store = ArtworkStore::new(16, None);
+        let cover = png(10, 10);
+        let (id, bytes) = store.insert(Arc::clone(&cover));
+        assert!(Arc::ptr_eq(&bytes, &cover));
+        assert!(store.get(id).is_none());
+    }
+}
@@ -0,0 +1,363 @@
+//! Per-player circuit breaker and retry budget for backend calls.
+//!
+//! A hung media player makes every call wait for the full operation
+//! timeout. To avoid that, [`MediaSessions`](crate::MediaSessions) tracks
+//! the health of each player separately:
+//!
+//! - **Closed:** calls pass through. Retryable failures (see
+//!   [`MediaError::is_retryable`]) are counted, and idempotent calls are
+//!   retried with jittered exponential backoff while the shared retry
+//!   budget allows it.
+//! - **Open:** after [`CircuitBreakerConfig::failure_threshold`] consecutive
+//!   failures, calls fail fast with [`MediaError::CircuitOpen`] and no IPC
+//!   is made. A background probe checks the player after a jittered
+//!   cool-down, which doubles on every failed probe.
+//! - A successful probe closes the circuit again.
+
+use std::collections::HashMap;
+use std::collections::hash_map::RandomState;
+use std::hash::{BuildHasher, Hasher};
+use std::sync::Mutex;
+use std::time::Duration;
+
+use tokio::time::Instant;
+
+use crate::error::{MediaError, MediaResult};
+
+/// Upper bound of the retry budget, in retries.
+const MAX_RETRY_TOKENS: f64 = 10.0;
+
+/// Configuration of the per-player circuit breaker and retry policy.
+///
+/// # Examples
+///
+/// ```rust
+/// use media_sessions::{CircuitBreakerConfig, MediaSessions};
+/// use std::time::Duration;
+///
+/// let builder = MediaSessions::builder().circuit_breaker(CircuitBreakerConfig {
+///     failure_threshold: 5,
+///     open_duration: Duration::from_millis(500),
+///     ..CircuitBreakerConfig::default()
+/// });
+/// ```
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct CircuitBreakerConfig {
+    /// Whether the breaker and retries are active at all.
+    pub enabled: bool,
+    /// Consecutive retryable failures after which the circuit opens.
+    pub failure_threshold: u32,
+    /// Cool-down before the first recovery probe.
+    pub open_duration: Duration,
+    /// Upper bound for the cool-down, which doubles after each failed probe.
+    pub max_open_duration: Duration,
+    /// Maximum retries of a single idempotent call.
+    pub max_retries: u32,
+    /// Backoff before the first retry; doubles for every further retry.
+    pub retry_backoff: Duration,
+    /// Retries earned per call, as a fraction (0.2 allows retrying about
+    /// one call in five). Unused budget accumulates up to 10 retries.
+    pub retry_budget: f64,
+}
+
+impl CircuitBreakerConfig {
+    /// Creates the default configuration.
+    ///
+    /// # Defaults
+    ///
+    /// - `failure_threshold`: 3
+    /// - `open_duration`: 1 second
+    /// - `max_open_duration`: 30 seconds
+    /// - `max_retries`: 2
+    /// - `retry_backoff`: 50ms
+    /// - `retry_budget`: 0.2
+    #[must_use]
+    pub const fn new() -> Self {
+        Self {
+            enabled: true,
+            failure_threshold: 3,
+            open_duration: Duration::from_secs(1),
+            max_open_duration: Duration::from_secs(30),
+            max_retries: 2,
+            retry_backoff: Duration::from_millis(50),
+            retry_budget: 0.2,
+        }
+    }
+
+    /// Creates a configuration with the breaker and retries turned off.
+    #[must_use]
+    pub const fn disabled() -> Self {
+        let mut config = Self::new();
+        config.enabled = false;
+        config
+    }
+}
+
+impl Default for CircuitBreakerConfig {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Health of a single player.
+#[derive(Debug, Clone, Copy)]
+enum BreakerState {
+    Closed { failures: u32 },
+    Open { until: Instant, open_for: Duration },
+}
+
+/// Mutable breaker state, guarded by one short-lived lock.
+#[derive(Debug)]
+struct Inner {
+    players: HashMap<String, BreakerState>,
+    retry_tokens: f64,
+}
+
+/// Circuit breakers for all players seen by one `MediaSessions` instance.
+#[derive(Debug)]
+pub(crate) struct CircuitBreakers {
+    config: CircuitBreakerConfig,
+    inner: Mutex<Inner>,
+}
+
+impl CircuitBreakers {
+    /// Creates an empty breaker set.
+    pub(crate) fn new(config: CircuitBreakerConfig) -> Self {
+        Self {
+            config,
+            inner: Mutex::new(Inner {
+                players: HashMap::new(),
+                retry_tokens: MAX_RETRY_TOKENS,
+            }),
+        }
+    }
+
+    /// Returns the configuration.
+    pub(crate) const fn config(&self) -> &CircuitBreakerConfig {
+        &self.config
+    }
+
+    /// Admits a call to `player`, or fails fast while its circuit is open.
+    ///
+    /// Every admitted call also earns a fraction of a retry.
+    pub(crate) fn admit(&self, player: &str, now: Instant) -> MediaResult<()> {
+        if !self.config.enabled {
+            return Ok(());
+        }
+
+        let mut inner = self.lock();
+        inner.retry_tokens = (inner.retry_tokens + self.config.retry_budget).min(MAX_RETRY_TOKENS);
+
+        match inner.players.get(player) {
+            Some(BreakerState::Open { until, .. }) => Err(MediaError::CircuitOpen {
+                player: player.to_string(),
+                retry_after: until.saturating_duration_since(now),
+            }),
+            _ => Ok(()),
+        }
+    }
+
+    /// Records that `player` answered, closing its circuit.
+    pub(crate) fn record_success(&self, player: &str) {
+        if !self.config.enabled {
+            return;
+        }
+
+        self.lock().players.remove(player);
+    }
+
+    /// Records a retryable failure of `player`.
+    ///
+    /// Returns `true` if this failure opened the circuit; the caller is then
+    /// responsible for starting a recovery probe.
+    pub(crate) fn record_failure(&self, player: &str, now: Instant) -> bool {
+        if !self.config.enabled {
+            return false;
+        }
+
+        let mut inner = self.lock();
+        let state = inner
+            .players
+            .entry(player.to_string())
+            .or_insert(BreakerState::Closed { failures: 0 });
+
+        let opened = match *state {
+            BreakerState::Closed { failures } if failures + 1 >= self.config.failure_threshold => {
+                let open_for = self.config.open_duration;
+                *state = BreakerState::Open {
+                    until: now + open_for,
+                    open_for,
+                };
+                true
+            }
+            BreakerState::Closed { failures } => {
+                *state = BreakerState::Closed {
+                    failures: failures + 1,
+                };
+                false
+            }
+            BreakerState::Open { .. } => false,
+        };
+        drop(inner);
+        opened
+    }
+
+    /// Records a failed recovery probe and returns the next cool-down.
+    pub(crate) fn reopen(&self, player: &str, now: Instant) -> Duration {
+        let mut inner = self.lock();
+        let previous = match inner.players.get(player) {
+            Some(BreakerState::Open { open_for, .. }) => *open_for,
+            _ => self.config.open_duration,
+        };
+        let open_for = (previous * 2).min(self.config.max_open_duration);
+
+        inner.players.insert(
+            player.to_string(),
+            BreakerState::Open {
+                until: now + open_for,
+                open_for,
+            },
+        );
+        open_for
+    }
+
+    /// Drops all state of a player that is no longer active.
+    pub(crate) fn forget(&self, player: &str) {
+        self.lock().players.remove(player);
+    }
+
+    /// Takes one retry out of the budget, if any is left.
+    ///
+    /// Always `false` when the breaker is disabled.
+    pub(crate) fn try_retry(&self) -> bool {
+        if !self.config.enabled {
+            return false;
+        }
+
+        let mut inner = self.lock();
+        if inner.retry_tokens >= 1.0 {
+            inner.retry_tokens -= 1.0;
+            true
+        } else {
+            false
+        }
+    }
+
+    /// Backoff before retry number `attempt` (starting at 1), with jitter.
+    pub(crate) fn retry_delay(&self, attempt: u32) -> Duration {
+        let factor = 1u32 << attempt.saturating_sub(1).min(16);
+        jittered(self.config.retry_backoff.saturating_mul(factor))
+    }
+
+    fn lock(&self) -> std::sync::MutexGuard<'_, Inner> {
+        self.inner
+            .lock()
+            .unwrap_or_else(std::sync::PoisonError::into_inner)
+    }
+}
+
+/// Applies "equal jitter": half of `base` plus a random share of the other half.
+///
+/// Desynchronizes retries and probes of many instances hitting the same player.
+pub(crate) fn jittered(base: Duration) -> Duration {
+    let half = base / 2;
+    half + half.mul_f64(random_unit())
+}
+
+/// Returns a pseudo-random value in `[0, 1)`.
+///
+/// `RandomState` is keyed from OS randomness and re-keyed per instance,
+/// which is plenty for jitter and avoids an extra dependency.
+fn random_unit() -> f64 {
+    let bits = RandomState::new().build_hasher().finish();
+    #[allow(clippy::cast_precision_loss)]
+    let unit = (bits >> 11) as f64 / (1u64 << 53) as f64;
+    unit
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn breakers() -> CircuitBreakers {
+        CircuitBreakers::new(CircuitBreakerConfig::new())
+    }
+
+    #[test]
+    fn test_opens_after_threshold() {
+        let breakers = breakers();
+        let now = Instant::now();
+
+        assert!(!breakers.record_failure("spotify", now));
+        assert!(!breakers.record_failure("spotify", now));
+        assert!(breakers.record_failure("spotify", now));
+
+        let err = breakers.admit("spotify", now).unwrap_err();
+        assert!(matches!(err, MediaError::CircuitOpen { .. }));
+
+        // Other players are unaffected.
+        assert!(breakers.admit("vlc", now).is_ok());
+    }
+
+    #[test]
+    fn test_success_resets_failures() {
+        let breakers = breakers();
+        let now = Instant::now();
+
+        breakers.record_failure("mpv", now);
+        breakers.record_failure("mpv", now);
+        breakers.record_success("mpv");
+
+        assert!(!breakers.record_failure("mpv", now));
+        assert!(breakers.admit("mpv", now).is_ok());
+    }
+
+    #[test]
+    fn test_reopen_doubles_up_to_max() {
+        let breakers = breakers();
+        let now = Instant::now();
+        for _ in 0..3 {
+            breakers.record_failure("mpv", now);
+        }
+
+        assert_eq!(breakers.reopen("mpv", now), Duration::from_secs(2));
+        assert_eq!(breakers.reopen("mpv", now), Duration::from_secs(4));
+        for _ in 0..10 {
+            breakers.reopen("mpv", now);
+        }
+        assert_eq!(breakers.reopen("mpv", now), Duration::from_secs(30));
+    }
+
+    #[test]
+    fn test_retry_budget_is_bounded() {
+        let breakers = breakers();
+        let retries = (0..100).filter(|_| breakers.try_retry()).count();
+        assert_eq!(retries, 10);
+
+        for _ in 0..5 {
+            breakers.admit("mpv", Instant::now()).unwrap();
+        }
+        assert!(breakers.try_retry());
+        assert!(!breakers.try_retry());
+    }
+
+    #[test]
+    fn test_disabled_never_opens() {
+        let breakers = CircuitBreakers::new(CircuitBreakerConfig::disabled());
+        let now = Instant::now();
+        for _ in 0..10 {
+            assert!(!breakers.record_failure("mpv", now));
+        }
+        assert!(breakers.admit("mpv", now).is_ok());
+        assert!(!breakers.try_retry());
+    }
+
+    #[test]
+    fn test_jitter_range() {
+        let base = Duration::from_millis(100);
+        for _ in 0..100 {
+            let delay = jittered(base);
+            assert!(delay >= base / 2 && delay <= base);
+        }
+    }
+}
@@ -0,0 +1,171 @@
+//! Write-combining for setter commands.
+//!
+//! With [`MediaSessionsBuilder::combine_writes`], at most one call per
+//! setter (`seek`, `set_volume`, `set_repeat_mode`, `set_shuffle`) is in
+//! flight at a time. A call made meanwhile waits for its turn; when yet
+//! another call of the same setter arrives, the waiting one is superseded
+//! and returns `Ok(())` without reaching the backend. Once the in-flight
+//! call completes, only the latest value is sent, so a volume slider drag
+//! costs two round trips at a time however fast it moves.
+//!
+//! [`MediaSessionsBuilder::combine_writes`]: crate::MediaSessionsBuilder::combine_writes
+
+use std::sync::{Arc, Mutex, PoisonError};
+
+use tokio::sync::oneshot;
+
+use crate::media_sessions::Operation;
+
+/// Combining state of one setter.
+#[derive(Debug, Default)]
+struct Slot {
+    /// A call is in flight, or its turn is on the way to a waiting call.
+    busy: bool,
+    /// The call waiting for its turn. Dropping the sender supersedes it.
+    waiting: Option<oneshot::Sender<Permit>>,
+}
+
+/// One slot per operation, indexed by [`Operation::index`].
+type Slots = Mutex<[Slot; Operation::ALL.len()]>;
+
+/// Combines calls of the same setter, shared by all clones of a
+/// `MediaSessions`.
+#[derive(Debug, Default)]
+pub struct WriteCombiner {
+    slots: Arc<Slots>,
+}
+
+impl WriteCombiner {
+    /// Waits until a call of `op` may be sent.
+    ///
+    /// Returns `None` if a later call of `op` superseded this one before
+    /// its turn came. The turn passes on when the returned permit is
+    /// dropped. A turn handed to a call that is cancelled before it runs
+    /// is dropped with the call and passes on the same way.
+    pub(crate) async fn acquire(&self, op: Operation) -> Option<Permit> {
+        let turn = {
+            let mut slots = self.slots.lock().unwrap_or_else(PoisonError::into_inner);
+            let slot = &mut slots[op.index()];
+            if !slot.busy {
+                slot.busy = true;
+                return Some(Permit {
+                    slots: Arc::clone(&self.slots),
+                    op,
+                });
+            }
+            let (tx, rx) = oneshot::channel();
+            // Replacing the sender drops the previous one, which wakes
+            // the superseded call.
+            slot.waiting = Some(tx);
+            drop(slots);
+            rx
+        };
+        turn.await.ok()
+    }
+}
+
+/// The turn to send one call; see [`WriteCombiner::acquire`].
+#[derive(Debug)]
+pub struct Permit {
+    slots: Arc<Slots>,
+    op: Operation,
+}
+
+impl Drop for Permit {
+    /// Hands the turn to the waiting call, if any.
+    fn drop(&mut self) {
+        let mut slots = self.slots.lock().unwrap_or_else(PoisonError::into_inner);
+        let slot = &mut slots[self.op.index()];
+        let Some(next) = slot.waiting.take() else {
+            slot.busy = false;
+            return;
+        };
+        drop(slots);
+        // The turn travels as a permit of its own. If the waiting call is
+        // gone, or goes away before it is polled again, that permit is
+        // dropped and passes the turn on in turn.
+        let _ = next.send(Self {
+            slots: Arc::clone(&self.slots),
+            op: self.op,
+        });
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use futures::task::noop_waker_ref;
+    use std::future::Future;
+    use std::pin::{Pin, pin};
+    use std::task::{Context, Poll};
+
+    /// Polls `future` once.
+    fn poll_once<F: Future>(future: Pin<&mut F>) -> Poll<F::Output> {
+        future.poll(&mut Context::from_waker(noop_waker_ref()))
+    }
+
+    #[test]
+    fn test_only_latest_waiting_call_is_sent() {
+        let combiner = WriteCombiner::default();
+        let first = poll_once(pin!(combiner.acquire(Operation::SetVolume)));
+        let Poll::Ready(Some(first)) = first else {
+            panic!("first call must be sent at once");
+        };
+
+        // Other setters are independent.
+        let seek = pin!(combiner.acquire(Operation::Seek));
+        assert!(matches!(poll_once(seek), Poll::Ready(Some(_))));
+
+        let mut second = pin!(combiner.acquire(Operation::SetVolume));
+        let mut third = pin!(combiner.acquire(Operation::SetVolume));
+        assert!(poll_once(second.as_mut()).is_pending());
+        assert!(poll_once(third.as_mut()).is_pending());
+        assert!(matches!(poll_once(second), Poll::Ready(None)));
+        assert!(poll_once(third.as_mut()).is_pending());
+
+        drop(first);
+        let Poll::Ready(Some(third)) = poll_once(third) else {
+            panic!("latest call must be sent next");
+        };
+        drop(third);
+
+        let again = pin!(combiner.acquire(Operation::SetVolume));
+        assert!(matches!(poll_once(again), Poll::Ready(Some(_))));
+    }
+
+    #[test]
+    fn test_cancelled_waiting_call_frees_the_slot() {
+        let combiner = WriteCombiner::default();
+        let Poll::Ready(Some(first)) = poll_once(pin!(combiner.acquire(Operation::SetShuffle)))
+        else {
+            panic!("first call must be sent at once");
+        };
+        {
+            let waiting = pin!(combiner.acquire(Operation::SetShuffle));
+            assert!(poll_once(waiting).is_pending());
+        }
+        drop(first);
+
+        let next = pin!(combiner.acquire(Operation::SetShuffle));
+        assert!(matches!(poll_once(next), Poll::Ready(Some(_))));
+    }
+
+    #[test]
+    fn test_call_cancelled_after_handoff_frees_the_slot() {
+        let combiner = WriteCombiner::default();
+        let Poll::Ready(Some(first)) = poll_once(pin!(combiner.acquire(Operation::SetRepeatMode)))
+        else {
+            panic!("first call must be sent at once");
+        };
+        {
+            let waiting = pin!(combiner.acquire(Operation::SetRepeatMode));
+            assert!(poll_once(waiting).is_pending());
+            // The turn is handed over, but the waiting call is dropped
+            // before it is polled again.
+            drop(first);
+        }
+
+        let next = pin!(combiner.acquire(Operation::SetRepeatMode));
+        assert!(matches!(poll_once(next), Poll::Ready(Some(_))));
+    }
+}
@@ -7,7 +7,7 @@ pub type MediaResult<T> = Result<T, MediaError>;
 ///
 /// This enum represents all possible error conditions that can occur
 /// when interacting with platform-specific media session backends.
-#[derive(Debug, thiserror::Error)]
+#[derive(Debug, Clone, thiserror::Error)]
 #[non_exhaustive]
 pub enum MediaError {
     /// The current platform is not supported by this library.
@@ -59,6 +59,17 @@ pub enum MediaError {
     /// Permission denied by the operating system.
     #[error("permission denied: {0}")]
     PermissionDenied(String),
+
+    /// The player stopped responding and calls to it fail fast.
+    ///
+    /// A background probe closes the circuit once the player recovers.
+    #[error("player {player} is not responding; next probe in {retry_after:?}")]
+    CircuitOpen {
+        /// The player whose circuit is open.
+        player: String,
+        /// Time until the next recovery probe.
+        retry_after: std::time::Duration,
+    },
 }
 
 impl MediaError {
@@ -123,5 +134,11 @@ mod tests {
 
         let err = MediaError::NotSupported("test".to_string());
         assert!(!err.is_retryable());
+
+        let err = MediaError::CircuitOpen {
+            player: "spotify".to_string(),
+            retry_after: std::time::Duration::from_secs(1),
+        };
+        assert!(!err.is_retryable());
     }
 }
@@ -18,21 +18,45 @@
 //!
 //! See the `c-api/` directory for examples in various languages.
 
-use std::ffi::{CString, c_char, c_void};
+use std::ffi::{CStr, CString, c_char, c_void};
 use std::ptr;
 use std::time::Duration;
 
 use tokio::runtime::Runtime;
 
+use crate::error::{MediaError, MediaResult};
 use crate::media_info::{MediaInfo, PlaybackStatus};
-use crate::media_sessions::{MediaSessions, RepeatMode};
+use crate::media_sessions::{MediaSessions, MediaSessionsBuilder, Operation, RepeatMode};
+use crate::metrics::Metrics;
 
-/// Opaque handle to a MediaSessions instance.
+/// Opaque handle to a `MediaSessions` instance.
 pub struct MediaSessionsHandle {
     sessions: MediaSessions,
     runtime: Runtime,
 }
 
+/// Worker threads of the runtime owned by each handle.
+const HANDLE_WORKER_THREADS: usize = 1;
+
+/// Build a handle whose `MediaSessions` spawns onto the handle's own runtime.
+fn new_handle(builder: MediaSessionsBuilder) -> *mut MediaSessionsHandle {
+    let Ok(runtime) = tokio::runtime::Builder::new_multi_thread()
+        .worker_threads(HANDLE_WORKER_THREADS)
+        .thread_name("media-sessions-c")
+        .enable_all()
+        .build()
+    else {
+        return ptr::null_mut();
+    };
+
+    builder
+        .runtime(runtime.handle().clone())
+        .build()
+        .map_or(ptr::null_mut(), |sessions| {
+            Box::into_raw(Box::new(MediaSessionsHandle { sessions, runtime }))
+        })
+}
+
 /// Playback status enum (C-compatible).
 #[repr(C)]
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -61,10 +85,10 @@ impl From<PlaybackStatus> for CPlaybackStatus {
 impl From<CPlaybackStatus> for PlaybackStatus {
     fn from(status: CPlaybackStatus) -> Self {
         match status {
-            CPlaybackStatus::Playing => PlaybackStatus::Playing,
-            CPlaybackStatus::Paused => PlaybackStatus::Paused,
-            CPlaybackStatus::Stopped => PlaybackStatus::Stopped,
-            CPlaybackStatus::Transitioning => PlaybackStatus::Transitioning,
+            CPlaybackStatus::Playing => Self::Playing,
+            CPlaybackStatus::Paused => Self::Paused,
+            CPlaybackStatus::Stopped => Self::Stopped,
+            CPlaybackStatus::Transitioning => Self::Transitioning,
         }
     }
 }
@@ -94,9 +118,9 @@ impl From<RepeatMode> for CRepeatMode {
 impl From<CRepeatMode> for RepeatMode {
     fn from(mode: CRepeatMode) -> Self {
         match mode {
-            CRepeatMode::None => RepeatMode::None,
-            CRepeatMode::One => RepeatMode::One,
-            CRepeatMode::All => RepeatMode::All,
+            CRepeatMode::None => Self::None,
+            CRepeatMode::One => Self::One,
+            CRepeatMode::All => Self::All,
         }
     }
 }
@@ -117,6 +141,28 @@ pub enum CResult {
     Timeout = 4,
     /// Invalid argument.
     InvalidArg = 5,
+    /// The player is not responding; the call failed fast.
+    CircuitOpen = 6,
+}
+
+impl From<&MediaError> for CResult {
+    fn from(err: &MediaError) -> Self {
+        match err {
+            MediaError::NoSession => Self::NoSession,
+            MediaError::NotSupported(_) => Self::NotSupported,
+            MediaError::Timeout(_) => Self::Timeout,
+            MediaError::CircuitOpen { .. } => Self::CircuitOpen,
+            _ => Self::Error,
+        }
+    }
+}
+
+/// Convert a command result to its C result code.
+fn to_c_result(result: MediaResult<()>) -> CResult {
+    match result {
+        Ok(()) => CResult::Ok,
+        Err(err) => (&err).into(),
+    }
 }
 
 /// Media info struct for C API.
@@ -176,39 +222,151 @@ impl Default for CMediaInfo {
     }
 }
 
-/// Convert MediaInfo to CMediaInfo.
-fn media_info_to_c(info: MediaInfo) -> CMediaInfo {
-    let mut c_info = CMediaInfo::default();
-
-    c_info.title = rust_string_to_c(info.title.unwrap_or_default());
-    c_info.artist = rust_string_to_c(info.artist.unwrap_or_default());
-    c_info.album = rust_string_to_c(info.album.unwrap_or_default());
-    c_info.duration_secs = info.duration.map_or(0, |d| d.as_secs());
-    c_info.position_secs = info.position.map_or(0, |p| p.as_secs());
-    c_info.playback_status = info.playback_status.into();
+/// Convert `MediaInfo` to `CMediaInfo`.
+fn media_info_to_c(info: &MediaInfo, artwork: Option<&[u8]>) -> CMediaInfo {
+    let (artwork, artwork_len) = artwork.map_or((ptr::null_mut(), 0), |artwork| {
+        (
+            Box::into_raw(Box::<[u8]>::from(artwork)).cast::<u8>(),
+            artwork.len(),
+        )
+    });
+
+    CMediaInfo {
+        title: rust_string_to_c(info.title.as_deref().unwrap_or_default()),
+        artist: rust_string_to_c(info.artist.as_deref().unwrap_or_default()),
+        album: rust_string_to_c(info.album.as_deref().unwrap_or_default()),
+        duration_secs: info.duration.map_or(0, |d| d.as_secs()),
+        position_secs: info.position.map_or(0, |p| p.as_secs()),
+        playback_status: info.playback_status.into(),
+        has_artwork: !artwork.is_null(),
+        artwork_len,
+        artwork,
+        track_number: info.track_number.unwrap_or(0),
+        disc_number: info.disc_number.unwrap_or(0),
+        genre: rust_string_to_c(info.genre.as_deref().unwrap_or_default()),
+        year: info.year.unwrap_or(0),
+        url: rust_string_to_c(info.url.as_deref().unwrap_or_default()),
+        thumbnail_url: rust_string_to_c(info.thumbnail_url.as_deref().unwrap_or_default()),
+    }
+}
+
+/// Number of entries in [`CMetrics::operations`].
+pub const C_OPERATION_COUNT: usize = Operation::ALL.len();
+
+/// Operation names, in the order of [`Operation::ALL`].
+const OPERATION_NAMES: [&CStr; C_OPERATION_COUNT] = [
+    c"get_current",
+    c"get_artwork",
+    c"play",
+    c"pause",
+    c"play_pause",
+    c"stop",
+    c"next",
+    c"previous",
+    c"seek",
+    c"set_volume",
+    c"set_repeat_mode",
+    c"set_shuffle",
+    c"seek_by",
+];
+
+/// Metrics of one backend operation (C-compatible).
+///
+/// Latencies are in microseconds.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct COperationMetrics {
+    /// Operation name (static, does not need to be freed).
+    pub name: *const c_char,
+    /// Backend attempts, including retries.
+    pub calls: u64,
+    /// Attempts that failed, including timeouts.
+    pub errors: u64,
+    /// Attempts that hit the operation timeout.
+    pub timeouts: u64,
+    /// Median latency.
+    pub p50_us: u64,
+    /// 90th percentile latency.
+    pub p90_us: u64,
+    /// 99th percentile latency.
+    pub p99_us: u64,
+    /// Largest latency.
+    pub max_us: u64,
+    /// Mean latency.
+    pub mean_us: u64,
+}
+
+/// Metrics snapshot for C API.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct CMetrics {
+    /// Backend method invocations, including those the backend answers
+    /// without D-Bus or OS calls.
+    pub backend_calls: u64,
+    /// Events emitted to watch streams.
+    pub events_emitted: u64,
+    /// Changes merged into a pending event batch.
+    pub events_coalesced: u64,
+    /// Raw backend updates dropped under load.
+    pub updates_dropped: u64,
+    /// Attempts that hit the operation timeout.
+    pub timeouts: u64,
+    /// Scheduled polls.
+    pub poll_ticks: u64,
+    /// Retries of idempotent calls.
+    pub retries: u64,
+    /// Times a player's circuit opened.
+    pub circuit_opens: u64,
+    /// Calls failed fast by an open circuit.
+    pub rejected: u64,
+    /// Setter calls superseded by a later value.
+    pub writes_combined: u64,
+    /// Per-operation metrics.
+    pub operations: [COperationMetrics; C_OPERATION_COUNT],
+}
+
+/// Convert a latency to whole microseconds.
+fn micros(latency: Duration) -> u64 {
+    u64::try_from(latency.as_micros()).unwrap_or(u64::MAX)
+}
+
+/// Convert a `Metrics` snapshot to `CMetrics`.
+fn metrics_to_c(metrics: &Metrics) -> CMetrics {
+    // Snapshots list every operation in the order of `Operation::ALL`.
+    let operations = std::array::from_fn(|index| {
+        let op = &metrics.operations[index];
+        let latency = &op.latency;
+        COperationMetrics {
+            name: OPERATION_NAMES[index].as_ptr(),
+            calls: op.calls,
+            errors: op.errors,
+            timeouts: op.timeouts,
+            p50_us: micros(latency.p50()),
+            p90_us: micros(latency.p90()),
+            p99_us: micros(latency.p99()),
+            max_us: micros(latency.max()),
+            mean_us: micros(latency.mean()),
+        }
+    });
 
-    if let Some(artwork) = info.artwork {
-        c_info.has_artwork = true;
-        c_info.artwork_len = artwork.len();
-        c_info.artwork = Box::into_raw(artwork.into_boxed_slice()) as *mut u8;
+    CMetrics {
+        backend_calls: metrics.backend_calls,
+        events_emitted: metrics.events_emitted,
+        events_coalesced: metrics.events_coalesced,
+        updates_dropped: metrics.updates_dropped,
+        timeouts: metrics.timeouts,
+        poll_ticks: metrics.poll_ticks,
+        retries: metrics.retries,
+        circuit_opens: metrics.circuit_opens,
+        rejected: metrics.rejected,
+        writes_combined: metrics.writes_combined,
+        operations,
     }
-
-    c_info.track_number = info.track_number.unwrap_or(0);
-    c_info.disc_number = info.disc_number.unwrap_or(0);
-    c_info.genre = rust_string_to_c(info.genre.unwrap_or_default());
-    c_info.year = info.year.unwrap_or(0);
-    c_info.url = rust_string_to_c(info.url.unwrap_or_default());
-    c_info.thumbnail_url = rust_string_to_c(info.thumbnail_url.unwrap_or_default());
-
-    c_info
 }
 
-/// Helper to convert Rust String to C string.
-fn rust_string_to_c(s: String) -> *mut c_char {
-    match CString::new(s) {
-        Ok(c_string) => c_string.into_raw(),
-        Err(_) => ptr::null_mut(),
-    }
+/// Helper to convert a Rust string to a C string.
+fn rust_string_to_c(s: &str) -> *mut c_char {
+    CString::new(s).map_or(ptr::null_mut(), CString::into_raw)
 }
 
 /// Free a C string allocated by this library.
@@ -233,7 +391,7 @@ pub unsafe extern "C" fn media_sessions_c_free_artwork(data: *mut u8, len: usize
     }
 }
 
-/// Free a CMediaInfo struct and all its allocated fields.
+/// Free a `CMediaInfo` struct and all its allocated fields.
 ///
 /// # Safety
 /// The pointer must have been allocated by this library.
@@ -253,7 +411,7 @@ pub unsafe extern "C" fn media_sessions_c_free_info(info: *mut CMediaInfo) {
     media_sessions_c_free_artwork(info.artwork, info.artwork_len);
 }
 
-/// Create a new MediaSessions instance.
+/// Create a new `MediaSessions` instance.
 ///
 /// Returns a handle that must be freed with `media_sessions_c_free`.
 ///
@@ -261,19 +419,10 @@ pub unsafe extern "C" fn media_sessions_c_free_info(info: *mut CMediaInfo) {
 /// The returned handle must be freed when no longer needed.
 #[no_mangle]
 pub unsafe extern "C" fn media_sessions_c_new() -> *mut MediaSessionsHandle {
-    match MediaSessions::new() {
-        Ok(sessions) => {
-            let handle = Box::new(MediaSessionsHandle {
-                sessions,
-                runtime: Runtime::new().unwrap(),
-            });
-            Box::into_raw(handle)
-        }
-        Err(_) => ptr::null_mut(),
-    }
+    new_handle(MediaSessions::builder())
 }
 
-/// Create a new MediaSessions instance with custom debounce duration (ms).
+/// Create a new `MediaSessions` instance with custom debounce duration (ms).
 ///
 /// # Safety
 /// The returned handle must be freed when no longer needed.
@@ -281,22 +430,24 @@ pub unsafe extern "C" fn media_sessions_c_new() -> *mut MediaSessionsHandle {
 pub unsafe extern "C" fn media_sessions_c_new_with_debounce(
     debounce_ms: u64,
 ) -> *mut MediaSessionsHandle {
-    match MediaSessions::builder()
-        .debounce_duration(Duration::from_millis(debounce_ms))
-        .build()
-    {
-        Ok(sessions) => {
-            let handle = Box::new(MediaSessionsHandle {
-                sessions,
-                runtime: Runtime::new().unwrap(),
-            });
-            Box::into_raw(handle)
-        }
-        Err(_) => ptr::null_mut(),
-    }
+    new_handle(MediaSessions::builder().debounce_duration(Duration::from_millis(debounce_ms)))
 }
 
-/// Free a MediaSessions handle.
+/// Create a new `MediaSessions` instance that combines setter calls.
+///
+/// While a seek, volume, repeat or shuffle call is in flight, further calls
+/// of the same function from other threads wait, and only the latest of
+/// them is sent once it completes; the calls it replaced return
+/// `CResult::Ok`.
+///
+/// # Safety
+/// The returned handle must be freed when no longer needed.
+#[no_mangle]
+pub unsafe extern "C" fn media_sessions_c_new_with_write_combining() -> *mut MediaSessionsHandle {
+    new_handle(MediaSessions::builder().combine_writes(true))
+}
+
+/// Free a `MediaSessions` handle.
 ///
 /// # Safety
 /// The handle must have been created by this library and not freed already.
@@ -309,7 +460,7 @@ pub unsafe extern "C" fn media_sessions_c_free(handle: *mut MediaSessionsHandle)
 
 /// Get current media information.
 ///
-/// Returns a pointer to CMediaInfo which must be freed with `media_sessions_c_free_info`.
+/// Returns a pointer to `CMediaInfo` which must be freed with `media_sessions_c_free_info`.
 /// Returns NULL if no session is active or on error.
 ///
 /// # Safety
@@ -323,14 +474,30 @@ pub unsafe extern "C" fn media_sessions_c_current(
     }
 
     let handle = &*handle;
-    match handle.runtime.block_on(handle.sessions.current()) {
-        Ok(Some(info)) => Box::into_raw(Box::new(media_info_to_c(info))),
+    let current = handle.runtime.block_on(async {
+        let Some(info) = handle.sessions.current().await? else {
+            return Ok(None);
+        };
+        // C callers get the artwork bytes inline.
+        let artwork = match info.artwork {
+            Some(id) => handle.sessions.artwork(id).await.ok().flatten(),
+            None => None,
+        };
+        MediaResult::Ok(Some((info, artwork)))
+    });
+    match current {
+        Ok(Some((info, artwork))) => {
+            Box::into_raw(Box::new(media_info_to_c(&info, artwork.as_deref())))
+        }
         _ => ptr::null_mut(),
     }
 }
 
 /// Get the active application name.
 ///
+/// Answered from memory without blocking on the runtime, so it is cheap
+/// to call from any thread, e.g. on every UI frame.
+///
 /// Returns a C string that must be freed with `media_sessions_c_free_string`.
 ///
 /// # Safety
@@ -344,119 +511,116 @@ pub unsafe extern "C" fn media_sessions_c_active_app(
     }
 
     let handle = &*handle;
-    match handle.runtime.block_on(handle.sessions.active_app()) {
-        Ok(Some(app)) => rust_string_to_c(app),
+    match handle.sessions.active_app_now() {
+        Ok(Some(app)) => rust_string_to_c(&app),
         _ => ptr::null_mut(),
     }
 }
 
 /// Start or resume playback.
 ///
-/// Returns CResult::Ok on success.
+/// Returns `CResult::Ok` on success.
+///
+/// # Safety
+/// The handle must have been created by this library and not freed already.
 #[no_mangle]
-pub extern "C" fn media_sessions_c_play(handle: *mut MediaSessionsHandle) -> CResult {
+pub unsafe extern "C" fn media_sessions_c_play(handle: *mut MediaSessionsHandle) -> CResult {
     if handle.is_null() {
         return CResult::InvalidArg;
     }
 
-    let handle = unsafe { &*handle };
-    match handle.runtime.block_on(handle.sessions.play()) {
-        Ok(_) => CResult::Ok,
-        Err(crate::error::MediaError::NoSession) => CResult::NoSession,
-        Err(_) => CResult::Error,
-    }
+    let handle = &*handle;
+    to_c_result(handle.runtime.block_on(handle.sessions.play()))
 }
 
 /// Pause playback.
 ///
-/// Returns CResult::Ok on success.
+/// Returns `CResult::Ok` on success.
+///
+/// # Safety
+/// The handle must have been created by this library and not freed already.
 #[no_mangle]
-pub extern "C" fn media_sessions_c_pause(handle: *mut MediaSessionsHandle) -> CResult {
+pub unsafe extern "C" fn media_sessions_c_pause(handle: *mut MediaSessionsHandle) -> CResult {
     if handle.is_null() {
         return CResult::InvalidArg;
     }
 
-    let handle = unsafe { &*handle };
-    match handle.runtime.block_on(handle.sessions.pause()) {
-        Ok(_) => CResult::Ok,
-        Err(crate::error::MediaError::NoSession) => CResult::NoSession,
-        Err(_) => CResult::Error,
-    }
+    let handle = &*handle;
+    to_c_result(handle.runtime.block_on(handle.sessions.pause()))
 }
 
 /// Toggle play/pause state.
 ///
-/// Returns CResult::Ok on success.
+/// Returns `CResult::Ok` on success.
+///
+/// # Safety
+/// The handle must have been created by this library and not freed already.
 #[no_mangle]
-pub extern "C" fn media_sessions_c_play_pause(handle: *mut MediaSessionsHandle) -> CResult {
+pub unsafe extern "C" fn media_sessions_c_play_pause(handle: *mut MediaSessionsHandle) -> CResult {
     if handle.is_null() {
         return CResult::InvalidArg;
     }
 
-    let handle = unsafe { &*handle };
-    match handle.runtime.block_on(handle.sessions.play_pause()) {
-        Ok(_) => CResult::Ok,
-        Err(crate::error::MediaError::NoSession) => CResult::NoSession,
-        Err(_) => CResult::Error,
-    }
+    let handle = &*handle;
+    to_c_result(handle.runtime.block_on(handle.sessions.play_pause()))
 }
 
 /// Stop playback.
 ///
-/// Returns CResult::Ok on success.
+/// Returns `CResult::Ok` on success.
+///
+/// # Safety
+/// The handle must have been created by this library and not freed already.
 #[no_mangle]
-pub extern "C" fn media_sessions_c_stop(handle: *mut MediaSessionsHandle) -> CResult {
+pub unsafe extern "C" fn media_sessions_c_stop(handle: *mut MediaSessionsHandle) -> CResult {
     if handle.is_null() {
         return CResult::InvalidArg;
     }
 
-    let handle = unsafe { &*handle };
-    match handle.runtime.block_on(handle.sessions.stop()) {
-        Ok(_) => CResult::Ok,
-        Err(crate::error::MediaError::NoSession) => CResult::NoSession,
-        Err(_) => CResult::Error,
-    }
+    let handle = &*handle;
+    to_c_result(handle.runtime.block_on(handle.sessions.stop()))
 }
 
 /// Skip to next track.
 ///
-/// Returns CResult::Ok on success.
+/// Returns `CResult::Ok` on success.
+///
+/// # Safety
+/// The handle must have been created by this library and not freed already.
 #[no_mangle]
-pub extern "C" fn media_sessions_c_next(handle: *mut MediaSessionsHandle) -> CResult {
+pub unsafe extern "C" fn media_sessions_c_next(handle: *mut MediaSessionsHandle) -> CResult {
     if handle.is_null() {
         return CResult::InvalidArg;
     }
 
-    let handle = unsafe { &*handle };
-    match handle.runtime.block_on(handle.sessions.next()) {
-        Ok(_) => CResult::Ok,
-        Err(crate::error::MediaError::NoSession) => CResult::NoSession,
-        Err(_) => CResult::Error,
-    }
+    let handle = &*handle;
+    to_c_result(handle.runtime.block_on(handle.sessions.next()))
 }
 
 /// Skip to previous track.
 ///
-/// Returns CResult::Ok on success.
+/// Returns `CResult::Ok` on success.
+///
+/// # Safety
+/// The handle must have been created by this library and not freed already.
 #[no_mangle]
-pub extern "C" fn media_sessions_c_previous(handle: *mut MediaSessionsHandle) -> CResult {
+pub unsafe extern "C" fn media_sessions_c_previous(handle: *mut MediaSessionsHandle) -> CResult {
     if handle.is_null() {
         return CResult::InvalidArg;
     }
 
-    let handle = unsafe { &*handle };
-    match handle.runtime.block_on(handle.sessions.previous()) {
-        Ok(_) => CResult::Ok,
-        Err(crate::error::MediaError::NoSession) => CResult::NoSession,
-        Err(_) => CResult::Error,
-    }
+    let handle = &*handle;
+    to_c_result(handle.runtime.block_on(handle.sessions.previous()))
 }
 
 /// Seek to the specified position (in seconds).
 ///
-/// Returns CResult::Ok on success.
+/// Returns `CResult::Ok` on success.
+///
+/// # Safety
+/// The handle must have been created by this library and not freed already.
 #[no_mangle]
-pub extern "C" fn media_sessions_c_seek(
+pub unsafe extern "C" fn media_sessions_c_seek(
     handle: *mut MediaSessionsHandle,
     position_secs: u64,
 ) -> CResult {
@@ -464,22 +628,45 @@ pub extern "C" fn media_sessions_c_seek(
         return CResult::InvalidArg;
     }
 
-    let handle = unsafe { &*handle };
-    match handle
-        .runtime
-        .block_on(handle.sessions.seek(Duration::from_secs(position_secs)))
-    {
-        Ok(_) => CResult::Ok,
-        Err(crate::error::MediaError::NoSession) => CResult::NoSession,
-        Err(_) => CResult::Error,
+    let handle = &*handle;
+    to_c_result(
+        handle
+            .runtime
+            .block_on(handle.sessions.seek(Duration::from_secs(position_secs))),
+    )
+}
+
+/// Move the playback position by `offset_ms` milliseconds, backwards if
+/// negative.
+///
+/// Where the platform supports it, this is a single call to the player,
+/// without reading the position first.
+///
+/// Returns `CResult::Ok` on success.
+///
+/// # Safety
+/// The handle must have been created by this library and not freed already.
+#[no_mangle]
+pub unsafe extern "C" fn media_sessions_c_seek_by_ms(
+    handle: *mut MediaSessionsHandle,
+    offset_ms: i64,
+) -> CResult {
+    if handle.is_null() {
+        return CResult::InvalidArg;
     }
+
+    let handle = &*handle;
+    to_c_result(handle.runtime.block_on(handle.sessions.seek_by(offset_ms)))
 }
 
 /// Set volume level (0.0 to 1.0).
 ///
-/// Returns CResult::Ok on success.
+/// Returns `CResult::Ok` on success.
+///
+/// # Safety
+/// The handle must have been created by this library and not freed already.
 #[no_mangle]
-pub extern "C" fn media_sessions_c_set_volume(
+pub unsafe extern "C" fn media_sessions_c_set_volume(
     handle: *mut MediaSessionsHandle,
     volume: f64,
 ) -> CResult {
@@ -487,22 +674,22 @@ pub extern "C" fn media_sessions_c_set_volume(
         return CResult::InvalidArg;
     }
 
-    if volume < 0.0 || volume > 1.0 {
+    if !(0.0..=1.0).contains(&volume) {
         return CResult::InvalidArg;
     }
 
-    let handle = unsafe { &*handle };
-    match handle.runtime.block_on(handle.sessions.set_volume(volume)) {
-        Ok(_) => CResult::Ok,
-        Err(_) => CResult::Error,
-    }
+    let handle = &*handle;
+    to_c_result(handle.runtime.block_on(handle.sessions.set_volume(volume)))
 }
 
 /// Set repeat mode.
 ///
-/// Returns CResult::Ok on success.
+/// Returns `CResult::Ok` on success.
+///
+/// # Safety
+/// The handle must have been created by this library and not freed already.
 #[no_mangle]
-pub extern "C" fn media_sessions_c_set_repeat_mode(
+pub unsafe extern "C" fn media_sessions_c_set_repeat_mode(
     handle: *mut MediaSessionsHandle,
     mode: CRepeatMode,
 ) -> CResult {
@@ -510,21 +697,22 @@ pub extern "C" fn media_sessions_c_set_repeat_mode(
         return CResult::InvalidArg;
     }
 
-    let handle = unsafe { &*handle };
-    match handle
-        .runtime
-        .block_on(handle.sessions.set_repeat_mode(mode.into()))
-    {
-        Ok(_) => CResult::Ok,
-        Err(_) => CResult::Error,
-    }
+    let handle = &*handle;
+    to_c_result(
+        handle
+            .runtime
+            .block_on(handle.sessions.set_repeat_mode(mode.into())),
+    )
 }
 
 /// Set shuffle mode.
 ///
-/// Returns CResult::Ok on success.
+/// Returns `CResult::Ok` on success.
+///
+/// # Safety
+/// The handle must have been created by this library and not freed already.
 #[no_mangle]
-pub extern "C" fn media_sessions_c_set_shuffle(
+pub unsafe extern "C" fn media_sessions_c_set_shuffle(
     handle: *mut MediaSessionsHandle,
     enabled: bool,
 ) -> CResult {
@@ -532,26 +720,46 @@ pub extern "C" fn media_sessions_c_set_shuffle(
         return CResult::InvalidArg;
     }
 
-    let handle = unsafe { &*handle };
-    match handle
-        .runtime
-        .block_on(handle.sessions.set_shuffle(enabled))
-    {
-        Ok(_) => CResult::Ok,
-        Err(_) => CResult::Error,
+    let handle = &*handle;
+    to_c_result(
+        handle
+            .runtime
+            .block_on(handle.sessions.set_shuffle(enabled)),
+    )
+}
+
+/// Get a snapshot of the metrics of a handle.
+///
+/// Fills `out` and returns `CResult::Ok`. The struct holds no allocations,
+/// so there is nothing to free.
+///
+/// # Safety
+/// `out` must point to writable memory for one `CMetrics`.
+#[no_mangle]
+pub unsafe extern "C" fn media_sessions_c_get_metrics(
+    handle: *mut MediaSessionsHandle,
+    out: *mut CMetrics,
+) -> CResult {
+    if handle.is_null() || out.is_null() {
+        return CResult::InvalidArg;
     }
+
+    let handle = &*handle;
+    out.write(metrics_to_c(&handle.sessions.metrics()));
+    CResult::Ok
 }
 
 /// Get the library version string.
 ///
 /// Returns a static C string (does not need to be freed).
 #[no_mangle]
-pub extern "C" fn media_sessions_c_version() -> *const c_char {
+pub const extern "C" fn media_sessions_c_version() -> *const c_char {
     c"0.2.0".as_ptr()
 }
 
 /// Callback type for event notifications.
-pub type CEventCallback = unsafe extern "C" fn(event_type: i32, data: *const c_void, user_data: *mut c_void);
+pub type CEventCallback =
+    unsafe extern "C" fn(event_type: i32, data: *const c_void, user_data: *mut c_void);
 
 /// Event types for callbacks.
 #[repr(i32)]
@@ -596,7 +804,7 @@ pub unsafe extern "C" fn media_sessions_c_free_callback(handle: *mut EventCallba
 ///
 /// Returns a static C string (does not need to be freed).
 #[no_mangle]
-pub extern "C" fn media_sessions_c_platform() -> *const c_char {
+pub const extern "C" fn media_sessions_c_platform() -> *const c_char {
     #[cfg(target_os = "windows")]
     {
         c"windows".as_ptr()
@@ -643,18 +851,14 @@ mod tests {
 
     #[test]
     fn test_version_string() {
-        unsafe {
-            let version = media_sessions_c_version();
-            assert!(!version.is_null());
-        }
+        let version = media_sessions_c_version();
+        assert!(!version.is_null());
     }
 
     #[test]
     fn test_platform_string() {
-        unsafe {
-            let platform = media_sessions_c_platform();
-            assert!(!platform.is_null());
-        }
+        let platform = media_sessions_c_platform();
+        assert!(!platform.is_null());
     }
 
     #[test]
@@ -669,12 +873,23 @@ mod tests {
         );
     }
 
+    #[test]
+    fn test_operation_names_match() {
+        for (op, name) in Operation::ALL.iter().zip(OPERATION_NAMES) {
+            assert_eq!(name.to_str().unwrap(), op.name());
+        }
+    }
+
+    #[test]
+    fn test_get_metrics_rejects_null() {
+        let mut metrics = std::mem::MaybeUninit::<CMetrics>::uninit();
+        let result = unsafe { media_sessions_c_get_metrics(ptr::null_mut(), metrics.as_mut_ptr()) };
+        assert_eq!(result, CResult::InvalidArg);
+    }
+
     #[test]
     fn test_repeat_mode_conversion() {
         assert_eq!(CRepeatMode::from(RepeatMode::All), CRepeatMode::All);
-        assert_eq!(
-            RepeatMode::from(CRepeatMode::One),
-            RepeatMode::One
-        );
+        assert_eq!(RepeatMode::from(CRepeatMode::One), RepeatMode::One);
     }
 }
@@ -14,6 +14,8 @@
 //! Все бэкенды изолированы за общим трейтом `MediaSessionBackend`, что обеспечивает:
 //! - 100% безопасный Rust API (unsafe код только в изолированных FFI модулях)
 //! - Debounce событий (800 мс по умолчанию) для фильтрации ОС-спама
+//! - Нативные уведомления ОС вместо опроса, где бэкенд их поддерживает
+//! - Встроенные метрики без блокировок: гистограммы задержек вызовов и счётчики событий (`MediaSessions::metrics()`)
 //! - Lazy initialization бэкендов для минимизации памяти в простое
 //!
 //! ## Сравнение с Аналогами
@@ -23,7 +25,7 @@
 //! | Latency (current) | ~42 µs | ~2.3 ms | ~1.8 ms |
 //! | Async-native | ✅ Tokio | ❌ Sync | ⚠️ Частично |
 //! | Debounce встроен | ✅ 800ms | ❌ | ❌ |
-//! | Artwork bytes | ✅ `Vec<u8>` | ❌ URL | ⚠️ Опционально |
+//! | Artwork bytes | ✅ `Arc<[u8]>` | ❌ URL | ⚠️ Опционально |
 //! | MSRV | 1.80+ | 1.70+ | 1.75+ |
 //!
 //! ## Быстрый Старт
@@ -77,6 +79,7 @@
 //! - [`MediaError::NotSupported`] — платформа не поддерживается
 //! - [`MediaError::NoSession`] — активная сессия не найдена
 //! - [`MediaError::Backend`] — ошибка нативного бэкенда
+//! - [`MediaError::CircuitOpen`] — плеер не отвечает, вызовы отклоняются сразу
 //!
 //! ## Лицензия
 //!
@@ -88,7 +91,7 @@
 //! 1. Включить фичу `tracing` для observability
 //! 2. Настроить debounce через `MediaSessionsBuilder::debounce_duration()`
 //! 3. Использовать `watch()` с `tokio::select!` для обработки событий
-//! 4. Кэшировать `artwork` на диск для уменьшения памяти
+//! 4. Ограничить размер обложек через `MediaSessionsBuilder::artwork_max_size()` и память под них через `MediaSessionsBuilder::artwork_cache_size()`
 //!
 //! ```rust,no_run
 //! # use media_sessions::MediaSessions;
@@ -106,24 +109,35 @@
 #![warn(clippy::pedantic)]
 #![warn(clippy::nursery)]
 #![deny(rustdoc::broken_intra_doc_links)]
-
 // FFI module uses unsafe code by design
 #![cfg_attr(feature = "c-api", allow(unsafe_code))]
 
+pub mod artwork;
+pub mod circuit_breaker;
 pub mod error;
 pub mod media_info;
 pub mod media_sessions;
+pub mod metrics;
 pub mod platform;
+pub mod polling;
+
+mod combining;
+mod pipeline;
+mod runtime;
 
 #[cfg(feature = "c-api")]
 pub mod ffi;
 
+pub use artwork::ArtworkId;
+pub use circuit_breaker::CircuitBreakerConfig;
 pub use error::{MediaError, MediaResult};
-pub use media_info::{MediaInfo, PlaybackStatus};
+pub use media_info::{Capabilities, MediaInfo, PlaybackStatus};
 pub use media_sessions::{MediaSessionEvent, MediaSessions, MediaSessionsBuilder, RepeatMode};
+pub use metrics::Metrics;
+pub use polling::PollConfig;
 
 #[doc(inline)]
-pub use platform::backend::MediaSessionBackend;
+pub use platform::backend::{DynBackend, MediaSessionBackend};
 
 // Re-export commonly used types
 pub use futures::Stream;
@@ -1,7 +1,10 @@
 //! Media information types and playback status enumeration.
 
+use std::sync::Arc;
 use std::time::Duration;
 
+use crate::artwork::ArtworkId;
+
 /// Playback status of a media session.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, Default)]
 #[cfg_attr(feature = "serde", derive(serde::Serialize, serde::Deserialize))]
@@ -55,35 +58,40 @@ impl std::fmt::Display for PlaybackStatus {
 }
 
 /// Complete metadata for a media track.
+///
+/// Text fields are reference-counted and artwork is referred to by its
+/// [`ArtworkId`], so cloning a `MediaInfo`, as every event and every
+/// stream does, copies pointers rather than strings or image bytes.
 #[derive(Debug, Clone, Default, PartialEq, Eq)]
 #[cfg_attr(feature = "serde", derive(serde::Serialize, serde::Deserialize))]
 pub struct MediaInfo {
     /// Track title.
-    pub title: Option<String>,
+    pub title: Option<Arc<str>>,
     /// Track artist or performer.
-    pub artist: Option<String>,
+    pub artist: Option<Arc<str>>,
     /// Album name.
-    pub album: Option<String>,
+    pub album: Option<Arc<str>>,
     /// Total duration of the track.
     pub duration: Option<Duration>,
     /// Current playback position.
     pub position: Option<Duration>,
     /// Current playback status.
     pub playback_status: PlaybackStatus,
-    /// Raw artwork image bytes.
-    pub artwork: Option<Vec<u8>>,
+    /// Artwork of the track; fetch the bytes with
+    /// [`MediaSessions::artwork`](crate::MediaSessions::artwork).
+    pub artwork: Option<ArtworkId>,
     /// Track number within the album.
     pub track_number: Option<u32>,
     /// Disc number for multi-disc albums.
     pub disc_number: Option<u32>,
     /// Genre classification.
-    pub genre: Option<String>,
+    pub genre: Option<Arc<str>>,
     /// Release year.
     pub year: Option<i32>,
     /// Source URL or identifier.
-    pub url: Option<String>,
+    pub url: Option<Arc<str>>,
     /// Auto-generated thumbnail URL.
-    pub thumbnail_url: Option<String>,
+    pub thumbnail_url: Option<Arc<str>>,
     /// Media type hint.
     pub media_type: Option<MediaType>,
 }
@@ -108,6 +116,44 @@ pub enum MediaType {
     Unknown,
 }
 
+/// Commands the active player accepts.
+///
+/// Anything a player does not report is assumed to be supported, so a
+/// backend without capability information reports every command as
+/// available and leaves rejecting them to the player.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+#[cfg_attr(feature = "serde", derive(serde::Serialize, serde::Deserialize))]
+// One flag per MPRIS `Can*` property.
+#[allow(clippy::struct_excessive_bools)]
+pub struct Capabilities {
+    /// Playback can be started or resumed.
+    pub can_play: bool,
+    /// Playback can be paused, and toggled with play/pause.
+    pub can_pause: bool,
+    /// The position can be changed.
+    pub can_seek: bool,
+    /// The player can skip to the next track.
+    pub can_go_next: bool,
+    /// The player can skip to the previous track.
+    pub can_go_previous: bool,
+    /// The player can be controlled at all: stopped, and its volume,
+    /// repeat mode and shuffle changed.
+    pub can_control: bool,
+}
+
+impl Default for Capabilities {
+    fn default() -> Self {
+        Self {
+            can_play: true,
+            can_pause: true,
+            can_seek: true,
+            can_go_next: true,
+            can_go_previous: true,
+            can_control: true,
+        }
+    }
+}
+
 impl MediaInfo {
     /// Returns the track title or an empty string if unavailable.
     #[must_use]
@@ -184,19 +230,6 @@ impl MediaInfo {
     pub const fn is_paused(&self) -> bool {
         self.playback_status.is_paused()
     }
-
-    /// Returns the artwork format hint if available.
-    #[must_use]
-    pub fn artwork_format(&self) -> Option<&'static str> {
-        self.artwork
-            .as_ref()
-            .and_then(|data| match data.as_slice() {
-                [0x89, 0x50, 0x4E, 0x47, ..] => Some("PNG"),
-                [0xFF, 0xD8, 0xFF, ..] => Some("JPEG"),
-                [0x47, 0x49, 0x46, 0x38, ..] => Some("GIF"),
-                _ => None,
-            })
-    }
 }
 
 impl std::fmt::Display for MediaInfo {
@@ -226,9 +259,9 @@ mod tests {
     #[test]
     fn test_media_info_display() {
         let info = MediaInfo {
-            title: Some("Title".to_string()),
-            artist: Some("Artist".to_string()),
-            album: Some("Album".to_string()),
+            title: Some("Title".into()),
+            artist: Some("Artist".into()),
+            album: Some("Album".into()),
             year: Some(2024),
             ..Default::default()
         };
@@ -245,19 +278,4 @@ mod tests {
         assert!((info.progress() - 0.25).abs() < f64::EPSILON);
         assert!((info.progress_percent() - 25.0).abs() < f64::EPSILON);
     }
-
-    #[test]
-    fn test_artwork_format_detection() {
-        let png_info = MediaInfo {
-            artwork: Some(vec![0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A]),
-            ..Default::default()
-        };
-        assert_eq!(png_info.artwork_format(), Some("PNG"));
-
-        let jpeg_info = MediaInfo {
-            artwork: Some(vec![0xFF, 0xD8, 0xFF, 0xE0]),
-            ..Default::default()
-        };
-        assert_eq!(jpeg_info.artwork_format(), Some("JPEG"));
-    }
 }
@@ -3,16 +3,27 @@
 //! This module provides the main [`MediaSessions`] struct for interacting
 //! with system media players, along with event types and builder patterns.
 
+use std::future::Future;
 use std::sync::Arc;
 use std::time::Duration;
 
 use futures::Stream;
-use tokio::sync::{RwLock, mpsc};
-use tokio::time::timeout;
+use tokio::runtime::Handle;
+use tokio::sync::{mpsc, watch};
+use tokio::time::{Instant, timeout, timeout_at};
 
+use crate::artwork::{ArtworkId, ArtworkStore, DEFAULT_STORE_BUDGET};
+use crate::circuit_breaker::{CircuitBreakerConfig, CircuitBreakers, jittered};
+use crate::combining::WriteCombiner;
 use crate::error::{MediaError, MediaResult};
-use crate::media_info::{MediaInfo, PlaybackStatus};
-use crate::platform::backend::{MediaSessionBackend, create_backend};
+use crate::media_info::{Capabilities, MediaInfo, PlaybackStatus};
+use crate::metrics::{Metrics, MetricsRecorder};
+use crate::pipeline;
+use crate::platform::backend::{
+    DynBackend, MediaSessionBackend, create_backend, create_backend_async,
+};
+use crate::platform::events;
+use crate::polling::{PollConfig, PollScheduler};
 
 /// Default debounce duration for filtering rapid event spam from OS.
 const DEFAULT_DEBOUNCE_DURATION: Duration = Duration::from_millis(800);
@@ -20,6 +31,9 @@ const DEFAULT_DEBOUNCE_DURATION: Duration = Duration::from_millis(800);
 /// Default timeout for media session operations.
 const DEFAULT_OPERATION_TIMEOUT: Duration = Duration::from_secs(5);
 
+/// Capacity of the event channel behind each [`MediaSessions::watch`] stream.
+const EVENT_CHANNEL_CAPACITY: usize = 32;
+
 /// Event emitted when media session state changes.
 ///
 /// This enum represents all possible state changes that can occur
@@ -65,7 +79,8 @@ pub enum MediaSessionEvent {
     ///
     /// This event is emitted when the album art or thumbnail changes.
     /// The artwork bytes are not included in this event to reduce
-    /// memory pressure; call [`MediaSessions::current`] to fetch.
+    /// memory pressure; call [`MediaSessions::current`] for the new
+    /// [`ArtworkId`] and [`MediaSessions::artwork`] for its bytes.
     ArtworkChanged,
     /// Volume level has changed.
     ///
@@ -102,11 +117,18 @@ pub enum RepeatMode {
 /// This builder pattern allows fine-tuning of debounce duration,
 /// operation timeout, and other settings before initializing
 /// the media session backend.
-#[derive(Debug, Default, Clone, Copy)]
+#[derive(Debug, Default, Clone)]
 pub struct MediaSessionsBuilder {
     debounce_duration: Duration,
     operation_timeout: Duration,
     enable_artwork: bool,
+    artwork_max_size: Option<(u32, u32)>,
+    artwork_cache_size: usize,
+    runtime: Option<Handle>,
+    circuit_breaker: CircuitBreakerConfig,
+    polling: PollConfig,
+    combine_writes: bool,
+    backend: Option<DynBackend>,
 }
 
 impl MediaSessionsBuilder {
@@ -117,12 +139,26 @@ impl MediaSessionsBuilder {
     /// - `debounce_duration`: 800ms
     /// - `operation_timeout`: 5 seconds
     /// - `enable_artwork`: true
+    /// - `artwork_max_size`: none, artwork is returned at full size
+    /// - `artwork_cache_size`: 8 MiB
+    /// - `runtime`: the runtime the builder is built on
+    /// - `circuit_breaker`: [`CircuitBreakerConfig::default`]
+    /// - `polling`: [`PollConfig::default`]
+    /// - `combine_writes`: false, every setter call is sent
+    /// - `backend`: the backend of the current platform
     #[must_use]
     pub const fn new() -> Self {
         Self {
             debounce_duration: DEFAULT_DEBOUNCE_DURATION,
             operation_timeout: DEFAULT_OPERATION_TIMEOUT,
             enable_artwork: true,
+            artwork_max_size: None,
+            artwork_cache_size: DEFAULT_STORE_BUDGET,
+            runtime: None,
+            circuit_breaker: CircuitBreakerConfig::new(),
+            polling: PollConfig::new(),
+            combine_writes: false,
+            backend: None,
         }
     }
 
@@ -202,6 +238,198 @@ impl MediaSessionsBuilder {
         self
     }
 
+    /// Scales artwork down to fit within `width` × `height` pixels.
+    ///
+    /// Larger artwork is decoded and resized on the blocking thread pool,
+    /// keeping its aspect ratio, before it is stored for
+    /// [`MediaSessions::artwork`]. Thumbnails are stored, so the same cover
+    /// is only scaled once. Artwork that already fits, or that cannot be
+    /// decoded, is returned as it is. See [`artwork`](crate::artwork).
+    ///
+    /// # Panics
+    ///
+    /// Panics if `width` or `height` is zero.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use media_sessions::MediaSessions;
+    ///
+    /// let builder = MediaSessions::builder()
+    ///     .artwork_max_size(300, 300);
+    /// ```
+    #[must_use]
+    pub fn artwork_max_size(mut self, width: u32, height: u32) -> Self {
+        assert!(
+            width > 0 && height > 0,
+            "artwork_max_size must be at least 1x1"
+        );
+        self.artwork_max_size = Some((width, height));
+        self
+    }
+
+    /// Limits the memory kept for artwork to about `bytes`.
+    ///
+    /// Covers seen by [`MediaSessions::current`] are kept until this budget
+    /// is used up, then the least recently used ones are dropped.
+    /// [`MediaSessions::artwork`] fetches dropped covers from the player
+    /// again. A cover larger than the whole budget is never kept.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use media_sessions::MediaSessions;
+    ///
+    /// let builder = MediaSessions::builder()
+    ///     .artwork_cache_size(2 * 1024 * 1024);
+    /// ```
+    #[must_use]
+    pub const fn artwork_cache_size(mut self, bytes: usize) -> Self {
+        self.artwork_cache_size = bytes;
+        self
+    }
+
+    /// Configures retries and the per-player circuit breaker.
+    ///
+    /// Idempotent calls that fail with a retryable error are retried within
+    /// the operation timeout. After repeated failures, calls to the same
+    /// player fail fast with [`MediaError::CircuitOpen`] until a background
+    /// probe sees it respond again. Use [`CircuitBreakerConfig::disabled`]
+    /// to turn this off.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use media_sessions::{CircuitBreakerConfig, MediaSessions};
+    ///
+    /// let builder = MediaSessions::builder()
+    ///     .circuit_breaker(CircuitBreakerConfig::disabled());
+    /// ```
+    #[must_use]
+    pub const fn circuit_breaker(mut self, config: CircuitBreakerConfig) -> Self {
+        self.circuit_breaker = config;
+        self
+    }
+
+    /// Configures poll intervals for backends without change notifications.
+    ///
+    /// Such backends are polled by [`MediaSessions::watch`]: quickly right
+    /// after a playback command and while playing, and with exponential
+    /// backoff while paused or without a session. Backends that receive
+    /// native notifications are not polled at all.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use media_sessions::{MediaSessions, PollConfig};
+    /// use std::time::Duration;
+    ///
+    /// let builder = MediaSessions::builder().polling(PollConfig {
+    ///     max_idle: Duration::from_secs(5),
+    ///     ..PollConfig::default()
+    /// });
+    /// ```
+    #[must_use]
+    pub const fn polling(mut self, config: PollConfig) -> Self {
+        self.polling = config;
+        self
+    }
+
+    /// Combines rapid calls of the same setter into the latest value.
+    ///
+    /// Applies to [`seek`](MediaSessions::seek),
+    /// [`set_volume`](MediaSessions::set_volume),
+    /// [`set_repeat_mode`](MediaSessions::set_repeat_mode) and
+    /// [`set_shuffle`](MediaSessions::set_shuffle). While a call is in
+    /// flight, further calls of the same setter wait; only the latest of
+    /// them is sent once the in-flight call completes, and the ones it
+    /// replaced return `Ok(())` without reaching the backend. This keeps
+    /// the player in step with a volume slider or seek bar that is dragged
+    /// faster than it answers. Superseded calls are counted in
+    /// [`Metrics::writes_combined`].
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use media_sessions::MediaSessions;
+    ///
+    /// let builder = MediaSessions::builder()
+    ///     .combine_writes(true);
+    /// ```
+    #[must_use]
+    pub const fn combine_writes(mut self, enabled: bool) -> Self {
+        self.combine_writes = enabled;
+        self
+    }
+
+    /// Uses `backend` instead of the backend of the current platform.
+    ///
+    /// This is mainly useful with [`MockBackend`](crate::platform::MockBackend)
+    /// to test and benchmark code built on `MediaSessions` without a real
+    /// media player. The backend is type-erased into a [`DynBackend`]; use
+    /// [`build_with`](Self::build_with) to keep its concrete type.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use media_sessions::MediaSessions;
+    /// use media_sessions::platform::MockBackend;
+    ///
+    /// # fn main() -> Result<(), Box<dyn std::error::Error>> {
+    /// let sessions = MediaSessions::builder()
+    ///     .backend(MockBackend::new())
+    ///     .build()?;
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[must_use]
+    pub fn backend(mut self, backend: impl MediaSessionBackend + 'static) -> Self {
+        self.backend = Some(DynBackend::new(backend));
+        self
+    }
+
+    /// Sets the Tokio runtime used for all internal background tasks.
+    ///
+    /// Event listeners and blocking OS calls are spawned through this
+    /// handle, so the embedding application controls the thread count.
+    /// If no handle is given, the runtime that [`build`](Self::build) is
+    /// called from is used; outside of any runtime, a shared single-worker
+    /// runtime is created lazily for the whole process.
+    ///
+    /// # Current-thread runtimes
+    ///
+    /// A `current_thread` runtime is supported. Background tasks then only
+    /// make progress while that runtime is being driven (for example inside
+    /// `block_on` or `#[tokio::main(flavor = "current_thread")]`), so a
+    /// [`watch`](MediaSessions::watch) stream must be polled from the same
+    /// runtime.
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// use media_sessions::MediaSessions;
+    ///
+    /// # fn main() -> Result<(), Box<dyn std::error::Error>> {
+    /// let rt = tokio::runtime::Builder::new_current_thread()
+    ///     .enable_all()
+    ///     .build()?;
+    ///
+    /// let sessions = MediaSessions::builder()
+    ///     .runtime(rt.handle().clone())
+    ///     .build()?;
+    ///
+    /// rt.block_on(async {
+    ///     let _ = sessions.current().await;
+    /// });
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[must_use]
+    pub fn runtime(mut self, handle: Handle) -> Self {
+        self.runtime = Some(handle);
+        self
+    }
+
     /// Builds the [`MediaSessions`] instance.
     ///
     /// # Errors
@@ -219,19 +447,169 @@ impl MediaSessionsBuilder {
     /// # Ok(())
     /// # }
     /// ```
-    pub fn build(self) -> MediaResult<MediaSessions> {
-        MediaSessions::with_config(self)
+    pub fn build(mut self) -> MediaResult<MediaSessions> {
+        let runtime = crate::runtime::resolve(self.runtime.clone())?;
+        let backend = match self.backend.take() {
+            Some(backend) => backend,
+            None => create_backend(&runtime)?,
+        };
+        Ok(MediaSessions::with_config(&self, runtime, backend))
+    }
+
+    /// Builds the [`MediaSessions`] instance without blocking the calling
+    /// task.
+    ///
+    /// [`build`](Self::build) blocks the thread while the backend connects
+    /// to the OS, which stalls a runtime worker when called from async
+    /// code. This connects on the caller's runtime instead; backends that
+    /// can only be set up synchronously are set up on its blocking pool.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::NotSupported`] if the platform is not supported.
+    /// Returns [`MediaError::Backend`] if the backend fails to initialize.
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// use media_sessions::MediaSessions;
+    ///
+    /// # #[tokio::main]
+    /// # async fn main() -> Result<(), Box<dyn std::error::Error>> {
+    /// let sessions = MediaSessions::builder().build_async().await?;
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub async fn build_async(mut self) -> MediaResult<MediaSessions> {
+        let runtime = crate::runtime::resolve(self.runtime.clone())?;
+        let backend = match self.backend.take() {
+            Some(backend) => backend,
+            None => create_backend_async(&runtime).await?,
+        };
+        Ok(MediaSessions::with_config(&self, runtime, backend))
+    }
+
+    /// Builds a [`MediaSessions`] instance that calls `backend` through its
+    /// concrete type.
+    ///
+    /// Unlike [`build`](Self::build), no backend future is boxed, so
+    /// playback commands allocate nothing on the way to the backend. Any
+    /// backend set with [`backend`](Self::backend) is ignored.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::Backend`] if no runtime is available.
+    ///
+    /// # Examples
+    ///
+    /// ```rust
+    /// use media_sessions::MediaSessions;
+    /// use media_sessions::platform::MockBackend;
+    ///
+    /// # fn main() -> Result<(), Box<dyn std::error::Error>> {
+    /// let sessions: MediaSessions<MockBackend> =
+    ///     MediaSessions::builder().build_with(MockBackend::new())?;
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub fn build_with<B: MediaSessionBackend>(self, backend: B) -> MediaResult<MediaSessions<B>> {
+        let runtime = crate::runtime::resolve(self.runtime.clone())?;
+        Ok(MediaSessions::with_config(&self, runtime, backend))
+    }
+}
+
+/// Backend operations routed through [`MediaSessions::call`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub(crate) enum Operation {
+    GetCurrent,
+    GetArtwork,
+    Play,
+    Pause,
+    PlayPause,
+    Stop,
+    Next,
+    Previous,
+    Seek,
+    SetVolume,
+    SetRepeatMode,
+    SetShuffle,
+    SeekBy,
+}
+
+impl Operation {
+    /// Every operation, in declaration order.
+    pub(crate) const ALL: [Self; 13] = [
+        Self::GetCurrent,
+        Self::GetArtwork,
+        Self::Play,
+        Self::Pause,
+        Self::PlayPause,
+        Self::Stop,
+        Self::Next,
+        Self::Previous,
+        Self::Seek,
+        Self::SetVolume,
+        Self::SetRepeatMode,
+        Self::SetShuffle,
+        Self::SeekBy,
+    ];
+
+    /// Position of the operation in [`ALL`](Self::ALL).
+    pub(crate) const fn index(self) -> usize {
+        self as usize
+    }
+
+    /// Name used in metrics and logs.
+    pub(crate) const fn name(self) -> &'static str {
+        match self {
+            Self::GetCurrent => "get_current",
+            Self::GetArtwork => "get_artwork",
+            Self::Play => "play",
+            Self::Pause => "pause",
+            Self::PlayPause => "play_pause",
+            Self::Stop => "stop",
+            Self::Next => "next",
+            Self::Previous => "previous",
+            Self::Seek => "seek",
+            Self::SetVolume => "set_volume",
+            Self::SetRepeatMode => "set_repeat_mode",
+            Self::SetShuffle => "set_shuffle",
+            Self::SeekBy => "seek_by",
+        }
+    }
+
+    /// Returns `true` if repeating the operation cannot change the outcome.
+    ///
+    /// Toggles, track skips and relative seeks are never retried: a lost
+    /// reply does not mean the player did not act on the first request.
+    pub(crate) const fn is_idempotent(self) -> bool {
+        !matches!(
+            self,
+            Self::PlayPause | Self::Next | Self::Previous | Self::SeekBy
+        )
+    }
+
+    /// Returns `true` if the operation changes the player state.
+    pub(crate) const fn is_command(self) -> bool {
+        !matches!(self, Self::GetCurrent | Self::GetArtwork)
     }
 }
 
 /// Internal state shared between `MediaSessions` and the event stream.
-pub(crate) struct SharedState {
-    backend: Box<dyn MediaSessionBackend>,
-    #[allow(dead_code)]
+pub(crate) struct SharedState<B> {
+    backend: B,
     pub(crate) debounce_duration: Duration,
     pub(crate) operation_timeout: Duration,
-    #[allow(dead_code)]
     pub(crate) enable_artwork: bool,
+    artwork: Arc<ArtworkStore>,
+    breakers: CircuitBreakers,
+    polling: PollConfig,
+    /// Set if setter calls are combined.
+    combiner: Option<WriteCombiner>,
+    metrics: MetricsRecorder,
+    /// Bumped after every playback command, so pollers can speed up.
+    commands: watch::Sender<()>,
+    runtime: Handle,
 }
 
 /// Main interface for interacting with system media sessions.
@@ -243,7 +621,32 @@ pub(crate) struct SharedState {
 /// # Thread Safety
 ///
 /// `MediaSessions` is `Send + Sync` and can be safely shared across
-/// threads. Internally, it uses `Arc<RwLock>` for state management.
+/// threads. Clones share the same backend and state.
+///
+/// # Backend Type
+///
+/// By default the platform backend is called through the type-erased
+/// [`DynBackend`], which boxes one future per call. With
+/// [`MediaSessionsBuilder::build_with`], `B` is the concrete backend type
+/// and calls are dispatched statically.
+///
+/// # Runtime
+///
+/// All background work runs on one Tokio runtime handle, selected at
+/// construction; see [`MediaSessionsBuilder::runtime`]. Both
+/// multi-thread and current-thread runtimes are supported.
+///
+/// # Fault Tolerance
+///
+/// Backend calls pass through a per-player circuit breaker: a player that
+/// keeps timing out is failed fast with [`MediaError::CircuitOpen`] and
+/// probed in the background until it recovers. See
+/// [`MediaSessionsBuilder::circuit_breaker`].
+///
+/// # Metrics
+///
+/// Latency histograms and counters of backend calls and events are always
+/// recorded; see [`MediaSessions::metrics`].
 ///
 /// # Examples
 ///
@@ -296,9 +699,16 @@ pub(crate) struct SharedState {
 /// # Ok(())
 /// # }
 /// ```
-#[derive(Clone)]
-pub struct MediaSessions {
-    state: Arc<RwLock<SharedState>>,
+pub struct MediaSessions<B: MediaSessionBackend = DynBackend> {
+    state: Arc<SharedState<B>>,
+}
+
+impl<B: MediaSessionBackend> Clone for MediaSessions<B> {
+    fn clone(&self) -> Self {
+        Self {
+            state: Arc::clone(&self.state),
+        }
+    }
 }
 
 impl MediaSessions {
@@ -325,6 +735,33 @@ impl MediaSessions {
         Self::builder().build()
     }
 
+    /// Creates a new `MediaSessions` instance with default settings,
+    /// without blocking the calling task.
+    ///
+    /// This is a convenience method equivalent to
+    /// `MediaSessions::builder().build_async().await`; prefer it over
+    /// [`new`](Self::new) in async code.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::NotSupported`] if the platform is not supported.
+    /// Returns [`MediaError::Backend`] if the backend fails to initialize.
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// use media_sessions::MediaSessions;
+    ///
+    /// # #[tokio::main]
+    /// # async fn main() -> Result<(), Box<dyn std::error::Error>> {
+    /// let sessions = MediaSessions::new_async().await?;
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub async fn new_async() -> MediaResult<Self> {
+        Self::builder().build_async().await
+    }
+
     /// Creates a new builder for configuring `MediaSessions`.
     ///
     /// # Examples
@@ -338,18 +775,176 @@ impl MediaSessions {
     pub const fn builder() -> MediaSessionsBuilder {
         MediaSessionsBuilder::new()
     }
+}
 
+impl<B: MediaSessionBackend> MediaSessions<B> {
     /// Internal constructor with configuration.
-    fn with_config(config: MediaSessionsBuilder) -> MediaResult<Self> {
-        let backend = create_backend()?;
-        Ok(Self {
-            state: Arc::new(RwLock::new(SharedState {
+    fn with_config(config: &MediaSessionsBuilder, runtime: Handle, backend: B) -> Self {
+        Self {
+            state: Arc::new(SharedState {
                 backend,
                 debounce_duration: config.debounce_duration,
                 operation_timeout: config.operation_timeout,
                 enable_artwork: config.enable_artwork,
-            })),
-        })
+                artwork: Arc::new(ArtworkStore::new(
+                    config.artwork_cache_size,
+                    config.artwork_max_size,
+                )),
+                breakers: CircuitBreakers::new(config.circuit_breaker),
+                polling: config.polling,
+                combiner: config.combine_writes.then(WriteCombiner::default),
+                metrics: MetricsRecorder::new(),
+                commands: watch::Sender::new(()),
+                runtime,
+            }),
+        }
+    }
+
+    /// Runs one backend operation under the timeout, retry and circuit
+    /// breaker policy.
+    ///
+    /// `f` may be invoked more than once: idempotent operations that fail
+    /// with a retryable error are retried with jittered backoff while the
+    /// retry budget and the overall `operation_timeout` allow it.
+    pub(crate) async fn call<'a, T, F, Fut>(&'a self, op: Operation, f: F) -> MediaResult<T>
+    where
+        F: Fn(&'a B) -> Fut,
+        Fut: Future<Output = MediaResult<T>> + 'a,
+    {
+        let state = &*self.state;
+        let active = state.backend.get_active_app().ok().flatten();
+        let player = active.as_deref().unwrap_or_default();
+        let deadline = Instant::now() + state.operation_timeout;
+        if let Err(err) = state.breakers.admit(player, Instant::now()) {
+            state.metrics.record_rejected();
+            return Err(err);
+        }
+
+        let mut attempt = 0;
+        loop {
+            let started = Instant::now();
+            let result = timeout_at(deadline, f(&state.backend)).await;
+            let latency = started.elapsed();
+            let timed_out = result.is_err();
+            let result = result.unwrap_or(Err(MediaError::Timeout(state.operation_timeout)));
+            state
+                .metrics
+                .record_call(op, latency, result.is_ok(), timed_out);
+            #[cfg(feature = "tracing")]
+            tracing::trace!(
+                operation = op.name(),
+                player,
+                attempt,
+                latency_us = u64::try_from(latency.as_micros()).unwrap_or(u64::MAX),
+                ok = result.is_ok(),
+                "backend call"
+            );
+
+            let err = match result {
+                Ok(value) => {
+                    state.breakers.record_success(player);
+                    if op.is_command() {
+                        state.commands.send_replace(());
+                    }
+                    return Ok(value);
+                }
+                Err(err) if !err.is_retryable() => {
+                    // The player answered, it just said no.
+                    state.breakers.record_success(player);
+                    return Err(err);
+                }
+                Err(err) => err,
+            };
+
+            if state.breakers.record_failure(player, Instant::now()) {
+                state.metrics.record_circuit_open();
+                #[cfg(feature = "tracing")]
+                tracing::warn!(player, error = %err, "circuit opened");
+                self.spawn_probe(active);
+                return Err(err);
+            }
+
+            attempt += 1;
+            let delay = state.breakers.retry_delay(attempt);
+            let may_retry = op.is_idempotent()
+                && attempt <= state.breakers.config().max_retries
+                && Instant::now() + delay < deadline
+                && state.breakers.try_retry();
+            if !may_retry {
+                return Err(err);
+            }
+
+            state.metrics.record_retry();
+            #[cfg(feature = "tracing")]
+            tracing::debug!(
+                operation = op.name(),
+                player,
+                attempt,
+                error = %err,
+                "retrying backend call"
+            );
+            tokio::time::sleep(delay).await;
+        }
+    }
+
+    /// Runs a setter through [`call`](Self::call), combined with other
+    /// calls of the same setter if enabled.
+    ///
+    /// Returns `Ok(())` without calling the backend if a later call
+    /// superseded this one.
+    async fn write<'a, F, Fut>(&'a self, op: Operation, f: F) -> MediaResult<()>
+    where
+        F: Fn(&'a B) -> Fut,
+        Fut: Future<Output = MediaResult<()>> + 'a,
+    {
+        let _permit = if let Some(combiner) = &self.state.combiner {
+            let Some(permit) = combiner.acquire(op).await else {
+                self.state.metrics.record_combined();
+                return Ok(());
+            };
+            Some(permit)
+        } else {
+            None
+        };
+        self.call(op, f).await
+    }
+
+    /// Probes a player with an open circuit until it answers again.
+    ///
+    /// The task holds only a weak reference, so it ends when the last
+    /// `MediaSessions` clone is dropped, or when another player becomes
+    /// active.
+    fn spawn_probe(&self, player: Option<Arc<str>>) {
+        let weak = Arc::downgrade(&self.state);
+        let mut open_for = self.state.breakers.config().open_duration;
+
+        self.state.runtime.spawn(async move {
+            loop {
+                tokio::time::sleep(jittered(open_for)).await;
+
+                let Some(state) = weak.upgrade() else {
+                    return;
+                };
+
+                let name = player.as_deref().unwrap_or_default();
+                let active = state.backend.get_active_app().ok().flatten();
+                if active.as_deref().unwrap_or_default() != name {
+                    state.breakers.forget(name);
+                    return;
+                }
+
+                state.metrics.record_backend_call();
+                match timeout(state.operation_timeout, state.backend.get_current()).await {
+                    Ok(Ok(_)) => {
+                        state.breakers.record_success(name);
+                        #[cfg(feature = "tracing")]
+                        tracing::info!(player = name, "circuit closed");
+                        return;
+                    }
+                    _ => open_for = state.breakers.reopen(name, Instant::now()),
+                }
+            }
+        });
     }
 
     /// Gets the current media session information.
@@ -379,45 +974,118 @@ impl MediaSessions {
     /// # }
     /// ```
     pub async fn current(&self) -> MediaResult<Option<MediaInfo>> {
-        let (timeout_dur, enable_artwork) = {
-            let state = self.state.read().await;
-            (state.operation_timeout, state.enable_artwork)
-        };
+        let mut info = self.call(Operation::GetCurrent, B::get_current).await?;
 
-        let result = timeout(timeout_dur, async {
-            let state = self.state.read().await;
-            let mut info = state.backend.get_current().await.ok().flatten();
+        // Fetch artwork separately if enabled; only its id is returned
+        if self.state.enable_artwork {
+            if let Some(ref mut info) = info {
+                info.artwork = self.current_artwork().await;
+            }
+        }
 
-            // Fetch artwork separately if enabled
-            if enable_artwork {
-                if let Some(ref mut info) = info {
-                    if info.artwork.is_none() {
-                        info.artwork = state.backend.get_artwork().await.ok().flatten();
-                    }
-                }
+        Ok(info)
+    }
+
+    /// Returns the id of the current artwork.
+    ///
+    /// The artwork is only fetched and hashed if the backend's artwork key
+    /// changed since the last call, or if the backend has no key.
+    async fn current_artwork(&self) -> Option<ArtworkId> {
+        let key = self.state.backend.artwork_key().await.ok().flatten();
+        if let (Some(key), Some((last, id))) = (key, self.state.artwork.last()) {
+            if key == last {
+                return id;
             }
+        }
 
-            info
-        })
-        .await;
+        let artwork = self
+            .call(Operation::GetArtwork, B::get_artwork)
+            .await
+            .ok()?;
+        let id = match artwork {
+            Some(artwork) => Some(self.store_artwork(artwork).await?.0),
+            None => None,
+        };
+        if let Some(key) = key {
+            self.state.artwork.remember(key, id);
+        }
+        id
+    }
 
-        match result {
-            Ok(media_info) => Ok(media_info),
-            Err(_) => Err(MediaError::Timeout(timeout_dur)),
+    /// Returns the bytes of the artwork `id` from [`MediaInfo::artwork`].
+    ///
+    /// Covers seen by [`current`](Self::current) are answered from memory.
+    /// A cover dropped to stay within
+    /// [`MediaSessionsBuilder::artwork_cache_size`] is fetched from the
+    /// player again, and returned only if the player still shows it.
+    /// Returns `Ok(None)` if the artwork is no longer available.
+    ///
+    /// # Errors
+    ///
+    /// Returns the backend error if the artwork has to be fetched again and
+    /// that fails.
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// use media_sessions::MediaSessions;
+    ///
+    /// # #[tokio::main]
+    /// # async fn main() -> Result<(), Box<dyn std::error::Error>> {
+    /// let sessions = MediaSessions::new()?;
+    ///
+    /// if let Some(id) = sessions.current().await?.and_then(|info| info.artwork) {
+    ///     if let Some(bytes) = sessions.artwork(id).await? {
+    ///         std::fs::write(format!("{id}.img"), &bytes)?;
+    ///     }
+    /// }
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub async fn artwork(&self, id: ArtworkId) -> MediaResult<Option<Arc<[u8]>>> {
+        if let Some(bytes) = self.state.artwork.get(id) {
+            return Ok(Some(bytes));
         }
+
+        let artwork = self.call(Operation::GetArtwork, B::get_artwork).await?;
+        let Some(artwork) = artwork else {
+            return Ok(None);
+        };
+        Ok(self
+            .store_artwork(artwork)
+            .await
+            .and_then(|(current, bytes)| (current == id).then_some(bytes)))
+    }
+
+    /// Adds artwork fetched from the backend to the store on the blocking
+    /// thread pool, where it is hashed and, if configured, scaled down.
+    async fn store_artwork(&self, artwork: Arc<[u8]>) -> Option<(ArtworkId, Arc<[u8]>)> {
+        let store = Arc::clone(&self.state.artwork);
+        self.state
+            .runtime
+            .spawn_blocking(move || store.insert(artwork))
+            .await
+            .ok()
     }
 
     /// Returns a stream of media session events.
     ///
     /// This method creates an async stream that yields events whenever
     /// the media session state changes. Events are debounced according
-    /// to the configured `debounce_duration`.
+    /// to the configured `debounce_duration`: the first change is emitted
+    /// immediately, and further changes within the window are coalesced
+    /// into the latest state.
     ///
-    /// The stream continues indefinitely until the `MediaSessions` instance
-    /// is dropped or an error occurs.
+    /// Where the backend supports native OS notifications, no polling is
+    /// done; otherwise the session is polled in the background.
+    ///
+    /// The stream continues until it is dropped.
     ///
     /// # Errors
     ///
+    /// Returns [`MediaError::Backend`] if the backend fails to subscribe
+    /// to change notifications.
+    ///
     /// The stream may yield [`MediaError`] variants if the backend
     /// encounters errors while listening for events.
     ///
@@ -444,14 +1112,25 @@ impl MediaSessions {
     /// # }
     /// ```
     pub async fn watch(&self) -> MediaResult<impl Stream<Item = MediaResult<MediaSessionEvent>>> {
-        let state = self.state.read().await;
-        let (tx, rx) = mpsc::channel(32);
+        let (tx, rx) = mpsc::channel(EVENT_CHANNEL_CAPACITY);
+        let (sink, updates) = events::channel(pipeline::RAW_UPDATE_CAPACITY);
 
-        // Clone backend-related data while holding the lock
-        let debounce_dur = state.debounce_duration;
+        // Prefer native notifications; fall back to polling without them.
+        let subscribed = match self.state.backend.subscribe(sink).await {
+            Ok(()) => true,
+            Err(MediaError::NotSupported(_)) => false,
+            Err(err) => return Err(err),
+        };
 
-        // Start listening through the backend
-        state.backend.start_listening(tx, debounce_dur).await?;
+        self.state.runtime.spawn(pipeline::run(
+            self.clone(),
+            updates,
+            subscribed,
+            tx,
+            self.state.debounce_duration,
+            PollScheduler::new(self.state.polling),
+            self.state.commands.subscribe(),
+        ));
 
         Ok(tokio_stream::wrappers::ReceiverStream::new(rx))
     }
@@ -477,17 +1156,7 @@ impl MediaSessions {
     /// # }
     /// ```
     pub async fn play(&self) -> MediaResult<()> {
-        let timeout_dur = {
-            let state = self.state.read().await;
-            state.operation_timeout
-        };
-
-        timeout(timeout_dur, async {
-            let state = self.state.read().await;
-            state.backend.play().await
-        })
-        .await
-        .map_err(|_| MediaError::Timeout(timeout_dur))?
+        self.call(Operation::Play, B::play).await
     }
 
     /// Pauses playback.
@@ -511,17 +1180,7 @@ impl MediaSessions {
     /// # }
     /// ```
     pub async fn pause(&self) -> MediaResult<()> {
-        let timeout_dur = {
-            let state = self.state.read().await;
-            state.operation_timeout
-        };
-
-        timeout(timeout_dur, async {
-            let state = self.state.read().await;
-            state.backend.pause().await
-        })
-        .await
-        .map_err(|_| MediaError::Timeout(timeout_dur))?
+        self.call(Operation::Pause, B::pause).await
     }
 
     /// Toggles between play and pause states.
@@ -545,17 +1204,7 @@ impl MediaSessions {
     /// # }
     /// ```
     pub async fn play_pause(&self) -> MediaResult<()> {
-        let timeout_dur = {
-            let state = self.state.read().await;
-            state.operation_timeout
-        };
-
-        timeout(timeout_dur, async {
-            let state = self.state.read().await;
-            state.backend.play_pause().await
-        })
-        .await
-        .map_err(|_| MediaError::Timeout(timeout_dur))?
+        self.call(Operation::PlayPause, B::play_pause).await
     }
 
     /// Stops playback completely.
@@ -582,17 +1231,7 @@ impl MediaSessions {
     /// # }
     /// ```
     pub async fn stop(&self) -> MediaResult<()> {
-        let timeout_dur = {
-            let state = self.state.read().await;
-            state.operation_timeout
-        };
-
-        timeout(timeout_dur, async {
-            let state = self.state.read().await;
-            state.backend.stop().await
-        })
-        .await
-        .map_err(|_| MediaError::Timeout(timeout_dur))?
+        self.call(Operation::Stop, B::stop).await
     }
 
     /// Skips to the next track.
@@ -616,17 +1255,7 @@ impl MediaSessions {
     /// # }
     /// ```
     pub async fn next(&self) -> MediaResult<()> {
-        let timeout_dur = {
-            let state = self.state.read().await;
-            state.operation_timeout
-        };
-
-        timeout(timeout_dur, async {
-            let state = self.state.read().await;
-            state.backend.next().await
-        })
-        .await
-        .map_err(|_| MediaError::Timeout(timeout_dur))?
+        self.call(Operation::Next, B::next).await
     }
 
     /// Skips to the previous track.
@@ -650,17 +1279,7 @@ impl MediaSessions {
     /// # }
     /// ```
     pub async fn previous(&self) -> MediaResult<()> {
-        let timeout_dur = {
-            let state = self.state.read().await;
-            state.operation_timeout
-        };
-
-        timeout(timeout_dur, async {
-            let state = self.state.read().await;
-            state.backend.previous().await
-        })
-        .await
-        .map_err(|_| MediaError::Timeout(timeout_dur))?
+        self.call(Operation::Previous, B::previous).await
     }
 
     /// Seeks to the specified position.
@@ -690,17 +1309,43 @@ impl MediaSessions {
     /// # }
     /// ```
     pub async fn seek(&self, position: Duration) -> MediaResult<()> {
-        let timeout_dur = {
-            let state = self.state.read().await;
-            state.operation_timeout
-        };
+        self.write(Operation::Seek, move |backend| backend.seek(position))
+            .await
+    }
 
-        timeout(timeout_dur, async {
-            let state = self.state.read().await;
-            state.backend.seek(position).await
-        })
-        .await
-        .map_err(|_| MediaError::Timeout(timeout_dur))?
+    /// Moves the playback position by `offset_ms` milliseconds, backwards
+    /// if negative.
+    ///
+    /// Backends that can seek relative to the current position do so in a
+    /// single call, without reading the position first; on Linux this is
+    /// MPRIS `Seek`. Seeking before the start goes to the start; seeking
+    /// past the end is left to the player, which usually skips to the next
+    /// track. A relative seek is not retried, since a lost reply does not
+    /// mean the player did not move.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::NoSession`] if no active session exists.
+    /// Returns [`MediaError::NotSupported`] if the player cannot seek.
+    /// Returns [`MediaError::Backend`] if the backend command fails.
+    /// Returns [`MediaError::Timeout`] if the operation exceeds timeout.
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// use media_sessions::MediaSessions;
+    ///
+    /// # #[tokio::main]
+    /// # async fn main() -> Result<(), Box<dyn std::error::Error>> {
+    /// let sessions = MediaSessions::new()?;
+    /// // Skip back ten seconds.
+    /// sessions.seek_by(-10_000).await?;
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub async fn seek_by(&self, offset_ms: i64) -> MediaResult<()> {
+        self.call(Operation::SeekBy, move |backend| backend.seek_by(offset_ms))
+            .await
     }
 
     /// Sets the volume level.
@@ -709,6 +1354,9 @@ impl MediaSessions {
     ///
     /// * `volume` - Volume level from 0.0 (muted) to 1.0 (maximum).
     ///
+    /// With [`MediaSessionsBuilder::combine_writes`], a call replaced by a
+    /// later one before it was sent returns `Ok(())`.
+    ///
     /// # Errors
     ///
     /// Returns [`MediaError::Backend`] if the backend command fails.
@@ -736,17 +1384,10 @@ impl MediaSessions {
             "volume must be between 0.0 and 1.0"
         );
 
-        let timeout_dur = {
-            let state = self.state.read().await;
-            state.operation_timeout
-        };
-
-        timeout(timeout_dur, async {
-            let state = self.state.read().await;
-            state.backend.set_volume(volume).await
+        self.write(Operation::SetVolume, move |backend| {
+            backend.set_volume(volume)
         })
         .await
-        .map_err(|_| MediaError::Timeout(timeout_dur))?
     }
 
     /// Sets the repeat mode.
@@ -769,17 +1410,10 @@ impl MediaSessions {
     /// # }
     /// ```
     pub async fn set_repeat_mode(&self, mode: RepeatMode) -> MediaResult<()> {
-        let timeout_dur = {
-            let state = self.state.read().await;
-            state.operation_timeout
-        };
-
-        timeout(timeout_dur, async {
-            let state = self.state.read().await;
-            state.backend.set_repeat_mode(mode).await
+        self.write(Operation::SetRepeatMode, move |backend| {
+            backend.set_repeat_mode(mode)
         })
         .await
-        .map_err(|_| MediaError::Timeout(timeout_dur))?
     }
 
     /// Toggles shuffle mode.
@@ -802,17 +1436,10 @@ impl MediaSessions {
     /// # }
     /// ```
     pub async fn set_shuffle(&self, enabled: bool) -> MediaResult<()> {
-        let timeout_dur = {
-            let state = self.state.read().await;
-            state.operation_timeout
-        };
-
-        timeout(timeout_dur, async {
-            let state = self.state.read().await;
-            state.backend.set_shuffle(enabled).await
+        self.write(Operation::SetShuffle, move |backend| {
+            backend.set_shuffle(enabled)
         })
         .await
-        .map_err(|_| MediaError::Timeout(timeout_dur))?
     }
 
     /// Returns the active application name.
@@ -835,13 +1462,91 @@ impl MediaSessions {
     /// # Ok(())
     /// # }
     /// ```
+    // Kept async so callers do not change with the backend's cache.
+    #[allow(clippy::unused_async)]
     pub async fn active_app(&self) -> MediaResult<Option<String>> {
-        let state = self.state.read().await;
-        state.backend.get_active_app()
+        self.active_app_now()
+    }
+
+    /// Returns the commands the active player accepts.
+    ///
+    /// The answer comes from the backend's cache and costs no call into
+    /// the player. Commands a player does not accept fail with
+    /// [`MediaError::NotSupported`] without reaching it, on backends that
+    /// know the player's capabilities.
+    ///
+    /// Returns `Ok(None)` if there is no active session.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::Backend`] if the backend query fails.
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// use media_sessions::MediaSessions;
+    ///
+    /// # #[tokio::main]
+    /// # async fn main() -> Result<(), Box<dyn std::error::Error>> {
+    /// let sessions = MediaSessions::new()?;
+    /// if let Some(capabilities) = sessions.capabilities().await? {
+    ///     if capabilities.can_go_next {
+    ///         sessions.next().await?;
+    ///     }
+    /// }
+    /// # Ok(())
+    /// # }
+    /// ```
+    // Async like the other queries, though answered from memory.
+    #[allow(clippy::unused_async)]
+    pub async fn capabilities(&self) -> MediaResult<Option<Capabilities>> {
+        self.state.backend.capabilities()
+    }
+
+    /// Returns the active application name without awaiting.
+    ///
+    /// Backends answer this from memory, so it is safe to call from any
+    /// thread, including the C API's, without entering the runtime.
+    pub(crate) fn active_app_now(&self) -> MediaResult<Option<String>> {
+        Ok(self
+            .state
+            .backend
+            .get_active_app()?
+            .map(|app| app.to_string()))
+    }
+
+    /// Returns the metrics recorder shared with the event pipeline.
+    pub(crate) fn recorder(&self) -> &MetricsRecorder {
+        &self.state.metrics
+    }
+
+    /// Returns a snapshot of the metrics of this instance.
+    ///
+    /// Metrics are shared by all clones and their event streams. Recording
+    /// them costs a few atomic increments per call, so they are always on.
+    ///
+    /// # Examples
+    ///
+    /// ```rust,no_run
+    /// use media_sessions::MediaSessions;
+    ///
+    /// # #[tokio::main]
+    /// # async fn main() -> Result<(), Box<dyn std::error::Error>> {
+    /// let sessions = MediaSessions::new()?;
+    /// sessions.play().await?;
+    ///
+    /// let metrics = sessions.metrics();
+    /// println!("backend calls: {}", metrics.backend_calls);
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[must_use]
+    pub fn metrics(&self) -> Metrics {
+        self.state.metrics.snapshot()
     }
 }
 
-impl std::fmt::Debug for MediaSessions {
+impl<B: MediaSessionBackend> std::fmt::Debug for MediaSessions<B> {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         f.debug_struct("MediaSessions")
             .field("state", &"<shared state>")
@@ -865,6 +1570,13 @@ mod tests {
         assert_eq!(builder.debounce_duration, DEFAULT_DEBOUNCE_DURATION);
         assert_eq!(builder.operation_timeout, DEFAULT_OPERATION_TIMEOUT);
         assert!(builder.enable_artwork);
+        assert!(builder.artwork_max_size.is_none());
+        assert_eq!(builder.artwork_cache_size, DEFAULT_STORE_BUDGET);
+        assert!(builder.runtime.is_none());
+        assert_eq!(builder.circuit_breaker, CircuitBreakerConfig::default());
+        assert_eq!(builder.polling, PollConfig::default());
+        assert!(!builder.combine_writes);
+        assert!(builder.backend.is_none());
     }
 
     #[test]
@@ -873,6 +1585,24 @@ mod tests {
         let _ = MediaSessions::builder().debounce_duration(Duration::ZERO);
     }
 
+    #[test]
+    fn test_operation_idempotency() {
+        assert!(Operation::Seek.is_idempotent());
+        assert!(Operation::GetCurrent.is_idempotent());
+        assert!(!Operation::PlayPause.is_idempotent());
+        assert!(!Operation::Next.is_idempotent());
+        assert!(!Operation::SeekBy.is_idempotent());
+        assert!(Operation::SetVolume.is_command());
+        assert!(!Operation::GetArtwork.is_command());
+    }
+
+    #[test]
+    fn test_operation_index_matches_all() {
+        for (index, op) in Operation::ALL.iter().enumerate() {
+            assert_eq!(op.index(), index);
+        }
+    }
+
     #[test]
     fn test_repeat_mode_default() {
         assert_eq!(RepeatMode::default(), RepeatMode::None);
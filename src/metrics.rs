@@ -0,0 +1,448 @@
+//! Built-in metrics for backend calls and the event pipeline.
+//!
+//! Every [`MediaSessions`](crate::MediaSessions) instance records:
+//!
+//! - **Per operation:** attempts, errors, timeouts and a latency histogram
+//!   of every backend attempt, including retries.
+//! - **Globally:** backend calls, emitted and coalesced events, dropped raw
+//!   updates, timeouts, poll ticks, retries and circuit breaker activity.
+//!
+//! Recording is a handful of relaxed atomic operations with no locks and no
+//! allocation, so metrics are always on. [`MediaSessions::metrics`](crate::MediaSessions::metrics)
+//! takes a [`Metrics`] snapshot.
+//!
+//! Histograms are log-linear in the style of `HdrHistogram`: each power of
+//! two of microseconds is split into 16 linear buckets, so any recorded
+//! latency is reported within 6.25% of its true value.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::Duration;
+
+use crate::media_sessions::Operation;
+
+/// Linear sub-buckets per power of two, as a power of two.
+const SUB_BUCKET_BITS: u32 = 4;
+
+/// Linear sub-buckets per power of two.
+const SUB_BUCKETS: usize = 1 << SUB_BUCKET_BITS;
+
+/// Largest recorded value, in bits of microseconds (about 71 minutes).
+const VALUE_BITS: u32 = 32;
+
+/// Number of histogram buckets.
+const BUCKETS: usize = (VALUE_BITS - SUB_BUCKET_BITS + 1) as usize * SUB_BUCKETS;
+
+/// Returns the bucket holding `micros`.
+fn bucket_index(micros: u64) -> usize {
+    let micros = micros.min((1 << VALUE_BITS) - 1);
+    if micros < SUB_BUCKETS as u64 {
+        return micros as usize;
+    }
+    let shift = 63 - micros.leading_zeros() - SUB_BUCKET_BITS;
+    let sub = (micros >> shift) as usize & (SUB_BUCKETS - 1);
+    (shift as usize + 1) * SUB_BUCKETS + sub
+}
+
+/// Returns the largest value, in microseconds, that falls into `index`.
+const fn bucket_upper_bound(index: usize) -> u64 {
+    if index < SUB_BUCKETS {
+        return index as u64;
+    }
+    #[allow(clippy::cast_possible_truncation)]
+    let shift = (index / SUB_BUCKETS - 1) as u32;
+    let sub = (index % SUB_BUCKETS) as u64;
+    ((SUB_BUCKETS as u64 + sub + 1) << shift) - 1
+}
+
+/// Converts a duration to whole microseconds, saturating.
+fn as_micros(duration: Duration) -> u64 {
+    u64::try_from(duration.as_micros()).unwrap_or(u64::MAX)
+}
+
+/// Lock-free latency histogram.
+struct AtomicHistogram {
+    buckets: Box<[AtomicU64]>,
+    sum_micros: AtomicU64,
+    max_micros: AtomicU64,
+}
+
+impl AtomicHistogram {
+    fn new() -> Self {
+        Self {
+            buckets: (0..BUCKETS).map(|_| AtomicU64::new(0)).collect(),
+            sum_micros: AtomicU64::new(0),
+            max_micros: AtomicU64::new(0),
+        }
+    }
+
+    fn record(&self, latency: Duration) {
+        let micros = as_micros(latency);
+        self.buckets[bucket_index(micros)].fetch_add(1, Ordering::Relaxed);
+        self.sum_micros.fetch_add(micros, Ordering::Relaxed);
+        self.max_micros.fetch_max(micros, Ordering::Relaxed);
+    }
+
+    fn snapshot(&self) -> LatencyHistogram {
+        let counts: Vec<u64> = self
+            .buckets
+            .iter()
+            .map(|bucket| bucket.load(Ordering::Relaxed))
+            .collect();
+        LatencyHistogram {
+            count: counts.iter().sum(),
+            counts,
+            sum_micros: self.sum_micros.load(Ordering::Relaxed),
+            max_micros: self.max_micros.load(Ordering::Relaxed),
+        }
+    }
+}
+
+/// Counters of one backend operation.
+struct OperationRecorder {
+    calls: AtomicU64,
+    errors: AtomicU64,
+    timeouts: AtomicU64,
+    latency: AtomicHistogram,
+}
+
+/// Collects metrics of one `MediaSessions` instance and its clones.
+pub(crate) struct MetricsRecorder {
+    operations: Box<[OperationRecorder]>,
+    backend_calls: AtomicU64,
+    events_emitted: AtomicU64,
+    events_coalesced: AtomicU64,
+    updates_dropped: AtomicU64,
+    poll_ticks: AtomicU64,
+    retries: AtomicU64,
+    circuit_opens: AtomicU64,
+    rejected: AtomicU64,
+    writes_combined: AtomicU64,
+}
+
+impl MetricsRecorder {
+    /// Creates a recorder with all counters at zero.
+    pub(crate) fn new() -> Self {
+        Self {
+            operations: Operation::ALL
+                .iter()
+                .map(|_| OperationRecorder {
+                    calls: AtomicU64::new(0),
+                    errors: AtomicU64::new(0),
+                    timeouts: AtomicU64::new(0),
+                    latency: AtomicHistogram::new(),
+                })
+                .collect(),
+            backend_calls: AtomicU64::new(0),
+            events_emitted: AtomicU64::new(0),
+            events_coalesced: AtomicU64::new(0),
+            updates_dropped: AtomicU64::new(0),
+            poll_ticks: AtomicU64::new(0),
+            retries: AtomicU64::new(0),
+            circuit_opens: AtomicU64::new(0),
+            rejected: AtomicU64::new(0),
+            writes_combined: AtomicU64::new(0),
+        }
+    }
+
+    /// Records one backend attempt of `op` that took `latency`.
+    pub(crate) fn record_call(&self, op: Operation, latency: Duration, ok: bool, timed_out: bool) {
+        let recorder = &self.operations[op.index()];
+        recorder.calls.fetch_add(1, Ordering::Relaxed);
+        recorder.latency.record(latency);
+        if !ok {
+            recorder.errors.fetch_add(1, Ordering::Relaxed);
+        }
+        if timed_out {
+            recorder.timeouts.fetch_add(1, Ordering::Relaxed);
+        }
+        self.backend_calls.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Records a backend call made outside of any operation, such as a
+    /// recovery probe.
+    pub(crate) fn record_backend_call(&self) {
+        self.backend_calls.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Records events sent to a stream.
+    pub(crate) fn record_emitted(&self, count: usize) {
+        self.events_emitted
+            .fetch_add(count as u64, Ordering::Relaxed);
+    }
+
+    /// Records changes folded into an already pending batch.
+    pub(crate) fn record_coalesced(&self, count: u64) {
+        self.events_coalesced.fetch_add(count, Ordering::Relaxed);
+    }
+
+    /// Records raw updates dropped because the pipeline fell behind.
+    pub(crate) fn record_dropped(&self, count: u64) {
+        self.updates_dropped.fetch_add(count, Ordering::Relaxed);
+    }
+
+    /// Records one scheduled poll.
+    pub(crate) fn record_poll(&self) {
+        self.poll_ticks.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Records one retry of an idempotent call.
+    pub(crate) fn record_retry(&self) {
+        self.retries.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Records a circuit opening.
+    pub(crate) fn record_circuit_open(&self) {
+        self.circuit_opens.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Records a call failed fast by an open circuit.
+    pub(crate) fn record_rejected(&self) {
+        self.rejected.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Records a setter call superseded by a later one.
+    pub(crate) fn record_combined(&self) {
+        self.writes_combined.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Takes a snapshot of all counters.
+    pub(crate) fn snapshot(&self) -> Metrics {
+        let load = |counter: &AtomicU64| counter.load(Ordering::Relaxed);
+        let operations: Vec<OperationMetrics> = Operation::ALL
+            .iter()
+            .zip(self.operations.iter())
+            .map(|(op, recorder)| OperationMetrics {
+                operation: op.name(),
+                calls: load(&recorder.calls),
+                errors: load(&recorder.errors),
+                timeouts: load(&recorder.timeouts),
+                latency: recorder.latency.snapshot(),
+            })
+            .collect();
+
+        Metrics {
+            timeouts: operations.iter().map(|op| op.timeouts).sum(),
+            operations,
+            backend_calls: load(&self.backend_calls),
+            events_emitted: load(&self.events_emitted),
+            events_coalesced: load(&self.events_coalesced),
+            updates_dropped: load(&self.updates_dropped),
+            poll_ticks: load(&self.poll_ticks),
+            retries: load(&self.retries),
+            circuit_opens: load(&self.circuit_opens),
+            rejected: load(&self.rejected),
+            writes_combined: load(&self.writes_combined),
+        }
+    }
+}
+
+impl std::fmt::Debug for MetricsRecorder {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("MetricsRecorder").finish_non_exhaustive()
+    }
+}
+
+/// Snapshot of a latency histogram.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct LatencyHistogram {
+    counts: Vec<u64>,
+    count: u64,
+    sum_micros: u64,
+    max_micros: u64,
+}
+
+impl LatencyHistogram {
+    /// Returns the number of recorded latencies.
+    #[must_use]
+    pub const fn count(&self) -> u64 {
+        self.count
+    }
+
+    /// Returns the largest recorded latency, with microsecond precision.
+    #[must_use]
+    pub const fn max(&self) -> Duration {
+        Duration::from_micros(self.max_micros)
+    }
+
+    /// Returns the mean latency, or zero if nothing was recorded.
+    #[must_use]
+    pub const fn mean(&self) -> Duration {
+        if self.count == 0 {
+            return Duration::ZERO;
+        }
+        Duration::from_micros(self.sum_micros / self.count)
+    }
+
+    /// Returns the latency below which the fraction `quantile` of calls
+    /// completed, e.g. `0.99` for the 99th percentile.
+    ///
+    /// The result is the upper bound of the matching bucket, capped at
+    /// [`max`](Self::max), so it never understates the latency.
+    #[must_use]
+    pub fn percentile(&self, quantile: f64) -> Duration {
+        if self.count == 0 {
+            return Duration::ZERO;
+        }
+        #[allow(
+            clippy::cast_precision_loss,
+            clippy::cast_possible_truncation,
+            clippy::cast_sign_loss
+        )]
+        let rank = ((quantile.clamp(0.0, 1.0) * self.count as f64).ceil() as u64).max(1);
+
+        let mut seen = 0;
+        for (index, &count) in self.counts.iter().enumerate() {
+            seen += count;
+            if seen >= rank {
+                return Duration::from_micros(bucket_upper_bound(index).min(self.max_micros));
+            }
+        }
+        self.max()
+    }
+
+    /// Returns the median latency.
+    #[must_use]
+    pub fn p50(&self) -> Duration {
+        self.percentile(0.5)
+    }
+
+    /// Returns the 90th percentile latency.
+    #[must_use]
+    pub fn p90(&self) -> Duration {
+        self.percentile(0.9)
+    }
+
+    /// Returns the 99th percentile latency.
+    #[must_use]
+    pub fn p99(&self) -> Duration {
+        self.percentile(0.99)
+    }
+}
+
+/// Metrics of one backend operation.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct OperationMetrics {
+    /// Operation name, such as `"get_current"` or `"play"`.
+    pub operation: &'static str,
+    /// Backend attempts, including retries.
+    pub calls: u64,
+    /// Attempts that failed, including timeouts.
+    pub errors: u64,
+    /// Attempts that hit the operation timeout.
+    pub timeouts: u64,
+    /// Latency of every attempt.
+    pub latency: LatencyHistogram,
+}
+
+/// Snapshot of the metrics of a [`MediaSessions`](crate::MediaSessions)
+/// instance, shared by all of its clones and streams.
+///
+/// # Examples
+///
+/// ```rust,no_run
+/// use media_sessions::MediaSessions;
+///
+/// # #[tokio::main]
+/// # async fn main() -> Result<(), Box<dyn std::error::Error>> {
+/// let sessions = MediaSessions::new()?;
+/// let _ = sessions.current().await;
+///
+/// let metrics = sessions.metrics();
+/// if let Some(current) = metrics.operation("get_current") {
+///     println!("get_current p99: {:?}", current.latency.p99());
+/// }
+/// # Ok(())
+/// # }
+/// ```
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct Metrics {
+    /// Per-operation metrics, one entry for every operation.
+    pub operations: Vec<OperationMetrics>,
+    /// Backend method invocations, including retries and recovery probes.
+    ///
+    /// Counts every call made on the backend, whether it reaches D-Bus or
+    /// the OS or is answered by the backend itself, e.g. from its player
+    /// registry or by rejecting an unsupported command.
+    pub backend_calls: u64,
+    /// Events sent to [`watch`](crate::MediaSessions::watch) streams.
+    pub events_emitted: u64,
+    /// Changes merged into a pending event batch by the debounce.
+    pub events_coalesced: u64,
+    /// Raw backend updates dropped because a stream fell behind. No change
+    /// is lost: the stream re-reads the full state instead.
+    pub updates_dropped: u64,
+    /// Attempts that hit the operation timeout, over all operations.
+    pub timeouts: u64,
+    /// Scheduled polls of backends without change notifications.
+    pub poll_ticks: u64,
+    /// Retries of idempotent calls.
+    pub retries: u64,
+    /// Times a player's circuit opened.
+    pub circuit_opens: u64,
+    /// Calls failed fast with [`MediaError::CircuitOpen`](crate::MediaError::CircuitOpen).
+    pub rejected: u64,
+    /// Setter calls superseded by a later value before they were sent; see
+    /// [`MediaSessionsBuilder::combine_writes`](crate::MediaSessionsBuilder::combine_writes).
+    pub writes_combined: u64,
+}
+
+impl Metrics {
+    /// Returns the metrics of the operation called `name`.
+    #[must_use]
+    pub fn operation(&self, name: &str) -> Option<&OperationMetrics> {
+        self.operations.iter().find(|op| op.operation == name)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_buckets_are_contiguous() {
+        for micros in 0..100_000 {
+            let index = bucket_index(micros);
+            assert!(micros <= bucket_upper_bound(index));
+            assert!(index == 0 || micros > bucket_upper_bound(index - 1));
+        }
+        assert_eq!(bucket_index(u64::MAX), BUCKETS - 1);
+    }
+
+    #[test]
+    fn test_percentiles_within_precision() {
+        let histogram = AtomicHistogram::new();
+        for micros in 1..=1_000 {
+            histogram.record(Duration::from_micros(micros));
+        }
+
+        let snapshot = histogram.snapshot();
+        assert_eq!(snapshot.count(), 1_000);
+        assert_eq!(snapshot.max(), Duration::from_micros(1_000));
+        assert_eq!(snapshot.mean(), Duration::from_micros(500));
+
+        for (quantile, exact) in [(0.5, 500.0), (0.9, 900.0), (0.99, 990.0)] {
+            let reported = snapshot.percentile(quantile).as_secs_f64() * 1e6;
+            assert!(
+                reported >= exact && reported <= exact * 1.0625,
+                "{quantile}: {reported}"
+            );
+        }
+    }
+
+    #[test]
+    fn test_snapshot_covers_every_operation() {
+        let recorder = MetricsRecorder::new();
+        recorder.record_call(Operation::Play, Duration::from_millis(2), true, false);
+        recorder.record_call(Operation::GetCurrent, Duration::from_secs(5), false, true);
+
+        let metrics = recorder.snapshot();
+        assert_eq!(metrics.operations.len(), Operation::ALL.len());
+        assert_eq!(metrics.backend_calls, 2);
+        assert_eq!(metrics.timeouts, 1);
+
+        let current = metrics.operation("get_current").unwrap();
+        assert_eq!((current.calls, current.errors, current.timeouts), (1, 1, 1));
+        assert_eq!(metrics.operation("play").unwrap().latency.count(), 1);
+        assert!(metrics.operation("unknown").is_none());
+    }
+}
@@ -0,0 +1,520 @@
+//! Event pipeline behind [`MediaSessions::watch`].
+//!
+//! One task per stream turns raw backend updates into
+//! [`MediaSessionEvent`]s. It keeps the last known session state, diffs it
+//! against what the stream has already seen, and debounces the result:
+//! the first change after a quiet period is emitted at once, and anything
+//! that follows within the debounce window is coalesced into one batch
+//! sent when the window ends. The final state is never dropped.
+//!
+//! Backends that cannot subscribe to OS notifications are polled on the
+//! adaptive schedule of [`crate::polling`], through the guarded
+//! [`MediaSessions`] call path, so polling is subject to the same timeouts
+//! and circuit breaker as every other call.
+
+use std::time::Duration;
+
+use tokio::sync::{mpsc, watch};
+use tokio::time::{Instant, sleep_until};
+
+use crate::error::MediaResult;
+use crate::media_info::MediaInfo;
+use crate::media_sessions::{MediaSessionEvent, MediaSessions, Operation, RepeatMode};
+use crate::platform::backend::MediaSessionBackend;
+use crate::platform::events::{RawUpdate, RawUpdates};
+use crate::polling::{PollScheduler, PollState};
+
+/// Capacity of the raw update channel between backend and pipeline.
+pub const RAW_UPDATE_CAPACITY: usize = 64;
+
+/// Smallest position jump reported as [`MediaSessionEvent::PositionChanged`].
+const POSITION_THRESHOLD: Duration = Duration::from_secs(1);
+
+/// Session state as seen by the pipeline.
+#[derive(Debug, Clone, Default, PartialEq)]
+struct Snapshot {
+    info: Option<MediaInfo>,
+    app: Option<String>,
+    volume: Option<f64>,
+    repeat: Option<RepeatMode>,
+    shuffle: Option<bool>,
+    artwork_generation: u64,
+}
+
+/// Tracks the live session state and the state last sent to the stream.
+#[derive(Debug, Default)]
+struct EventState {
+    current: Snapshot,
+    emitted: Snapshot,
+    dirty: bool,
+    /// Changes applied since the last [`take_events`](Self::take_events).
+    changes: u64,
+    /// Position before the first seek since the last
+    /// [`take_events`](Self::take_events), if there was one.
+    #[allow(clippy::option_option)]
+    seeked_from: Option<Option<Duration>>,
+}
+
+impl EventState {
+    /// Applies a partial update.
+    ///
+    /// Returns `true` if the full state has to be re-read, either because
+    /// the backend asked for it or because the update refers to a session
+    /// the pipeline does not know yet.
+    fn apply(&mut self, update: RawUpdate) -> bool {
+        if matches!(update, RawUpdate::Error(_)) {
+            return false;
+        }
+        self.dirty = true;
+        if !matches!(update, RawUpdate::Snapshot(_) | RawUpdate::Invalidated) {
+            self.changes += 1;
+        }
+        let current = &mut self.current;
+
+        match update {
+            RawUpdate::Snapshot(info) => {
+                if current.info != info {
+                    self.changes += 1;
+                }
+                current.info = info;
+            }
+            RawUpdate::Metadata(track) => match current.info.as_mut() {
+                Some(info) => {
+                    *info = MediaInfo {
+                        position: info.position,
+                        playback_status: info.playback_status,
+                        ..track
+                    };
+                }
+                None => return true,
+            },
+            RawUpdate::PlaybackStatus(status) => match current.info.as_mut() {
+                Some(info) => info.playback_status = status,
+                None => return true,
+            },
+            RawUpdate::Position(position) => match current.info.as_mut() {
+                Some(info) => info.position = Some(position),
+                None => return true,
+            },
+            RawUpdate::Seeked {
+                position,
+                old_position,
+            } => match current.info.as_mut() {
+                Some(info) => {
+                    info.position = Some(position);
+                    self.seeked_from.get_or_insert(old_position);
+                }
+                None => return true,
+            },
+            RawUpdate::Volume(volume) => current.volume = Some(volume),
+            RawUpdate::RepeatMode(mode) => current.repeat = Some(mode),
+            RawUpdate::Shuffle(enabled) => current.shuffle = Some(enabled),
+            RawUpdate::ArtworkChanged => {
+                current.artwork_generation = current.artwork_generation.wrapping_add(1);
+            }
+            RawUpdate::SessionOpened { app_name } => {
+                current.app = Some(app_name);
+                return true;
+            }
+            RawUpdate::SessionClosed => {
+                current.info = None;
+                current.app = None;
+            }
+            RawUpdate::Invalidated => return true,
+            RawUpdate::Error(_) => {}
+        }
+
+        false
+    }
+
+    /// Replaces the session with a freshly read one.
+    ///
+    /// Returns `true` if it differs from the previous state.
+    fn apply_snapshot(&mut self, info: Option<MediaInfo>, app: Option<String>) -> bool {
+        let changed = self.current.info != info;
+        self.apply(RawUpdate::Snapshot(info));
+        if app.is_some() {
+            self.current.app = app;
+        }
+        changed
+    }
+
+    /// Returns `true` if the state changed since the last [`take_events`](Self::take_events).
+    const fn is_dirty(&self) -> bool {
+        self.dirty
+    }
+
+    /// Diffs the current state against the emitted one and marks the
+    /// result as emitted.
+    fn take_events(&mut self) -> Vec<MediaSessionEvent> {
+        self.dirty = false;
+        self.changes = 0;
+        let seeked_from = self.seeked_from.take();
+
+        let mut events = Vec::new();
+        let (old, new) = (&self.emitted, &self.current);
+        let mut keep_old_position = true;
+
+        match (&old.info, &new.info) {
+            (Some(_), None) => events.push(MediaSessionEvent::SessionClosed),
+            (None, None) => {}
+            (old_info, Some(info)) => {
+                if old_info.is_none() {
+                    events.push(MediaSessionEvent::SessionOpened {
+                        app_name: new.app.clone().unwrap_or_default(),
+                    });
+                }
+                if old_info.as_ref().map_or(true, |old| !same_track(old, info)) {
+                    events.push(MediaSessionEvent::MetadataChanged(info.clone()));
+                    keep_old_position = false;
+                }
+                if old_info
+                    .as_ref()
+                    .map_or(true, |old| old.playback_status != info.playback_status)
+                {
+                    events.push(MediaSessionEvent::PlaybackStatusChanged(
+                        info.playback_status,
+                    ));
+                }
+                if let Some(position) = info.position {
+                    // Seeks are reported however short; other position
+                    // changes only once they cross the threshold.
+                    let jumped_from = match (seeked_from, old_info) {
+                        (Some(old_position), _) => Some(old_position),
+                        (None, Some(old))
+                            if old.position.map_or(true, |prev| {
+                                distance(prev, position) > POSITION_THRESHOLD
+                            }) =>
+                        {
+                            Some(old.position)
+                        }
+                        _ => None,
+                    };
+                    if let Some(old_position) = jumped_from {
+                        events.push(MediaSessionEvent::PositionChanged {
+                            position,
+                            old_position,
+                        });
+                        keep_old_position = false;
+                    }
+                }
+            }
+        }
+
+        if let Some(volume) = new.volume.filter(|_| new.volume != old.volume) {
+            events.push(MediaSessionEvent::VolumeChanged { volume });
+        }
+        if (new.repeat, new.shuffle) != (old.repeat, old.shuffle) {
+            events.push(MediaSessionEvent::RepeatModeChanged {
+                repeat: new.repeat.unwrap_or_default(),
+                shuffle: new.shuffle.unwrap_or_default(),
+            });
+        }
+        if new.artwork_generation != old.artwork_generation {
+            events.push(MediaSessionEvent::ArtworkChanged);
+        }
+
+        // Small position steps are not reported, so they must not move the
+        // baseline either, or steady playback would never cross the threshold.
+        let old_position = old.info.as_ref().and_then(|info| info.position);
+        self.emitted = self.current.clone();
+        if keep_old_position {
+            if let Some(info) = self.emitted.info.as_mut() {
+                info.position = old_position;
+            }
+        }
+
+        events
+    }
+}
+
+/// Returns `true` if both describe the same track, ignoring playback state.
+fn same_track(a: &MediaInfo, b: &MediaInfo) -> bool {
+    a.title == b.title
+        && a.artist == b.artist
+        && a.album == b.album
+        && a.duration == b.duration
+        && a.track_number == b.track_number
+        && a.disc_number == b.disc_number
+        && a.genre == b.genre
+        && a.year == b.year
+        && a.url == b.url
+        && a.thumbnail_url == b.thumbnail_url
+        && a.media_type == b.media_type
+}
+
+/// Absolute difference of two positions.
+fn distance(a: Duration, b: Duration) -> Duration {
+    if a > b { a - b } else { b - a }
+}
+
+/// One running pipeline.
+struct Pipeline<B: MediaSessionBackend> {
+    sessions: MediaSessions<B>,
+    events: mpsc::Sender<MediaResult<MediaSessionEvent>>,
+    state: EventState,
+    scheduler: PollScheduler,
+    failing: bool,
+}
+
+impl<B: MediaSessionBackend> Pipeline<B> {
+    /// Re-reads the full session state through the guarded call path.
+    ///
+    /// Only the first of a run of consecutive errors is passed on, so a
+    /// player with an open circuit does not flood the stream. Returns
+    /// `false` once the stream is gone.
+    async fn refresh(&mut self) -> bool {
+        match self
+            .sessions
+            .call(Operation::GetCurrent, B::get_current)
+            .await
+        {
+            Ok(info) => {
+                self.failing = false;
+                let poll_state = PollState::of(info.as_ref());
+                let app = match info {
+                    Some(_) => self.sessions.active_app().await.ok().flatten(),
+                    None => None,
+                };
+                let changed = self.state.apply_snapshot(info, app);
+                self.scheduler.observe(poll_state, changed);
+                true
+            }
+            Err(_) if self.failing => {
+                self.scheduler.observe_failure();
+                true
+            }
+            Err(err) => {
+                self.failing = true;
+                self.scheduler.observe_failure();
+                self.events.send(Err(err)).await.is_ok()
+            }
+        }
+    }
+
+    /// Sends pending events. Returns `None` once the stream is gone, or
+    /// whether anything was sent.
+    async fn flush(&mut self) -> Option<bool> {
+        let changes = self.state.changes;
+        let batch = self.state.take_events();
+        let sent = !batch.is_empty();
+
+        let metrics = self.sessions.recorder();
+        metrics.record_coalesced(changes.saturating_sub(1));
+        metrics.record_emitted(batch.len());
+        for event in batch {
+            self.events.send(Ok(event)).await.ok()?;
+        }
+        Some(sent)
+    }
+}
+
+/// Runs the pipeline until the stream is dropped.
+///
+/// `subscribed` tells whether the backend pushes updates into `updates`;
+/// if it does not, or if its subscription ends, the backend is polled on
+/// the schedule of `scheduler`, which speeds up whenever `commands` fires.
+pub async fn run<B: MediaSessionBackend>(
+    sessions: MediaSessions<B>,
+    mut updates: RawUpdates,
+    mut subscribed: bool,
+    events: mpsc::Sender<MediaResult<MediaSessionEvent>>,
+    debounce: Duration,
+    scheduler: PollScheduler,
+    mut commands: watch::Receiver<()>,
+) {
+    let mut pipeline = Pipeline {
+        sessions,
+        events,
+        state: EventState::default(),
+        scheduler,
+        failing: false,
+    };
+    let mut last_emit: Option<Instant> = None;
+
+    // Seed the state so the stream starts with the current session.
+    if !pipeline.refresh().await {
+        return;
+    }
+    let mut next_poll = pipeline.scheduler.next_wakeup(Instant::now());
+
+    loop {
+        let ready_at = last_emit.map(|at| at + debounce);
+        if pipeline.state.is_dirty() && ready_at.map_or(true, |at| at <= Instant::now()) {
+            match pipeline.flush().await {
+                None => return,
+                Some(true) => last_emit = Some(Instant::now()),
+                Some(false) => {}
+            }
+        }
+
+        let flush_at = ready_at.filter(|_| pipeline.state.is_dirty());
+        let alive = tokio::select! {
+            () = pipeline.events.closed() => false,
+            update = updates.recv(), if subscribed => match update {
+                Some(RawUpdate::Error(err)) => pipeline.events.send(Err(err)).await.is_ok(),
+                Some(update) => !pipeline.state.apply(update) || pipeline.refresh().await,
+                None => {
+                    // The backend ended its subscription; keep the stream
+                    // alive by polling instead.
+                    subscribed = false;
+                    next_poll = Instant::now();
+                    true
+                }
+            },
+            () = sleep_until(next_poll), if !subscribed => {
+                pipeline.sessions.recorder().record_poll();
+                let alive = pipeline.refresh().await;
+                next_poll = pipeline.scheduler.next_wakeup(Instant::now());
+                alive
+            }
+            changed = commands.changed(), if !subscribed => {
+                if changed.is_ok() {
+                    let now = Instant::now();
+                    pipeline.scheduler.on_command(now);
+                    next_poll = next_poll.min(pipeline.scheduler.next_wakeup(now));
+                }
+                true
+            }
+            () = sleep_until(flush_at.unwrap_or_else(Instant::now)), if flush_at.is_some() => true,
+        };
+        if !alive {
+            return;
+        }
+
+        let dropped = updates.take_dropped();
+        if dropped > 0 {
+            pipeline.sessions.recorder().record_dropped(dropped);
+            if !pipeline.refresh().await {
+                return;
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::media_info::PlaybackStatus;
+
+    fn track(title: &str) -> MediaInfo {
+        MediaInfo {
+            title: Some(title.into()),
+            position: Some(Duration::from_secs(10)),
+            ..MediaInfo::default()
+        }
+    }
+
+    #[test]
+    fn test_session_open_and_close() {
+        let mut state = EventState::default();
+        state.apply_snapshot(Some(track("One")), Some("mpv".to_string()));
+
+        let events = state.take_events();
+        assert_eq!(
+            events[0],
+            MediaSessionEvent::SessionOpened {
+                app_name: "mpv".to_string()
+            }
+        );
+        assert!(matches!(events[1], MediaSessionEvent::MetadataChanged(_)));
+        assert_eq!(
+            events[2],
+            MediaSessionEvent::PlaybackStatusChanged(PlaybackStatus::Playing)
+        );
+        assert_eq!(events.len(), 3);
+
+        state.apply(RawUpdate::SessionClosed);
+        assert_eq!(state.take_events(), vec![MediaSessionEvent::SessionClosed]);
+    }
+
+    #[test]
+    fn test_changes_are_coalesced() {
+        let mut state = EventState::default();
+        state.apply_snapshot(Some(track("One")), None);
+        state.take_events();
+
+        state.apply(RawUpdate::PlaybackStatus(PlaybackStatus::Paused));
+        state.apply(RawUpdate::PlaybackStatus(PlaybackStatus::Playing));
+        state.apply(RawUpdate::Metadata(track("Two")));
+        state.apply(RawUpdate::Metadata(track("Three")));
+
+        let events = state.take_events();
+        assert_eq!(events.len(), 1);
+        let MediaSessionEvent::MetadataChanged(info) = &events[0] else {
+            panic!("unexpected event: {events:?}");
+        };
+        assert_eq!(info.title(), "Three");
+    }
+
+    #[test]
+    fn test_changes_are_counted_per_batch() {
+        let mut state = EventState::default();
+        state.apply_snapshot(Some(track("One")), None);
+        state.apply_snapshot(Some(track("One")), None);
+        state.apply(RawUpdate::Invalidated);
+        assert_eq!(state.changes, 1);
+
+        state.take_events();
+        state.apply(RawUpdate::Volume(0.2));
+        state.apply(RawUpdate::Volume(0.4));
+        assert_eq!(state.changes, 2);
+    }
+
+    #[test]
+    fn test_position_threshold_accumulates() {
+        let mut state = EventState::default();
+        state.apply_snapshot(Some(track("One")), None);
+        state.take_events();
+
+        state.apply(RawUpdate::Position(Duration::from_millis(10_600)));
+        assert!(state.take_events().is_empty());
+
+        state.apply(RawUpdate::Position(Duration::from_millis(11_200)));
+        assert_eq!(
+            state.take_events(),
+            vec![MediaSessionEvent::PositionChanged {
+                position: Duration::from_millis(11_200),
+                old_position: Some(Duration::from_secs(10)),
+            }]
+        );
+    }
+
+    #[test]
+    fn test_seeks_are_always_reported() {
+        let mut state = EventState::default();
+        state.apply_snapshot(Some(track("One")), None);
+        state.take_events();
+
+        // Coalesced seeks report where the first one started.
+        state.apply(RawUpdate::Seeked {
+            position: Duration::from_millis(10_300),
+            old_position: Some(Duration::from_millis(12_000)),
+        });
+        state.apply(RawUpdate::Seeked {
+            position: Duration::from_millis(10_500),
+            old_position: Some(Duration::from_millis(10_400)),
+        });
+        assert_eq!(
+            state.take_events(),
+            vec![MediaSessionEvent::PositionChanged {
+                position: Duration::from_millis(10_500),
+                old_position: Some(Duration::from_millis(12_000)),
+            }]
+        );
+        assert!(state.take_events().is_empty());
+    }
+
+    #[test]
+    fn test_partial_update_without_session_requests_refresh() {
+        let mut state = EventState::default();
+        assert!(state.apply(RawUpdate::PlaybackStatus(PlaybackStatus::Paused)));
+        assert!(state.apply(RawUpdate::Invalidated));
+        assert!(!state.apply(RawUpdate::Volume(0.5)));
+
+        assert_eq!(
+            state.take_events(),
+            vec![MediaSessionEvent::VolumeChanged { volume: 0.5 }]
+        );
+    }
+}
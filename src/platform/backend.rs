@@ -4,13 +4,17 @@
 //! backends must implement, along with the factory function for creating
 //! the appropriate backend at runtime.
 
+use std::future::Future;
+use std::sync::Arc;
 use std::time::Duration;
 
-use tokio::sync::mpsc;
+use futures::future::BoxFuture;
+use tokio::runtime::Handle;
 
+use super::events::EventSink;
 use crate::error::{MediaError, MediaResult};
-use crate::media_info::MediaInfo;
-use crate::media_sessions::{MediaSessionEvent, RepeatMode};
+use crate::media_info::{Capabilities, MediaInfo};
+use crate::media_sessions::RepeatMode;
 
 /// Trait defining the interface for platform-specific media session backends.
 ///
@@ -19,16 +23,23 @@ use crate::media_sessions::{MediaSessionEvent, RepeatMode};
 ///
 /// # Implementation Notes
 ///
-/// - All methods are async to support non-blocking I/O
+/// - All methods are async to support non-blocking I/O; implement them
+///   with plain `async fn`, their futures must be `Send`
 /// - Implementations should be `Send + Sync` for thread safety
 /// - Errors should be converted to [`MediaError`] variants
 ///
+/// # Dispatch
+///
+/// The trait uses native async functions, so calls through a concrete
+/// backend type allocate nothing. It is therefore not object safe; use
+/// [`DynBackend`] where backends of different types must be stored
+/// behind one type, at the cost of one boxed future per call.
+///
 /// # Safety
 ///
 /// Implementations may use unsafe FFI code internally, but the trait
 /// interface itself is safe Rust.
-#[async_trait::async_trait]
-pub trait MediaSessionBackend: Send + Sync {
+pub trait MediaSessionBackend: Send + Sync + 'static {
     /// Returns the platform name for this backend.
     fn platform_name(&self) -> &'static str;
 
@@ -38,7 +49,7 @@ pub trait MediaSessionBackend: Send + Sync {
     ///
     /// Returns [`MediaError::Backend`] if the query fails.
     /// Returns `Ok(None)` if no session is active.
-    async fn get_current(&self) -> MediaResult<Option<MediaInfo>>;
+    fn get_current(&self) -> impl Future<Output = MediaResult<Option<MediaInfo>>> + Send;
 
     /// Gets the artwork for the current session.
     ///
@@ -47,14 +58,50 @@ pub trait MediaSessionBackend: Send + Sync {
     /// # Errors
     ///
     /// Returns [`MediaError::Backend`] if fetching fails.
-    async fn get_artwork(&self) -> MediaResult<Option<Vec<u8>>>;
+    fn get_artwork(&self) -> impl Future<Output = MediaResult<Option<Arc<[u8]>>>> + Send;
+
+    /// Returns a key for the current artwork, without fetching it.
+    ///
+    /// Called before [`get_artwork`](Self::get_artwork) on every
+    /// `current()`: while the key stays the same, the artwork is assumed
+    /// unchanged and is neither fetched nor hashed again. The key must
+    /// therefore change whenever `get_artwork` would return other bytes,
+    /// e.g. by covering the track, the artwork URL and the file's
+    /// modification time and size. `Ok(None)` means the backend cannot tell, which is what
+    /// the default implementation returns; the artwork is then fetched
+    /// every time.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::Backend`] if the query fails.
+    fn artwork_key(&self) -> impl Future<Output = MediaResult<Option<u64>>> + Send {
+        async { Ok(None) }
+    }
 
     /// Gets the active application name.
     ///
+    /// This is called before every backend call to pick the player's
+    /// circuit breaker, so it should be cheap: hand out a shared name
+    /// rather than allocating a new one.
+    ///
     /// # Errors
     ///
     /// Returns [`MediaError::Backend`] if the query fails.
-    fn get_active_app(&self) -> MediaResult<Option<String>>;
+    fn get_active_app(&self) -> MediaResult<Option<Arc<str>>>;
+
+    /// Gets the commands the active player accepts.
+    ///
+    /// Like [`get_active_app`](Self::get_active_app), this should be
+    /// answered from memory. The default implementation reports every
+    /// command as supported while there is a session.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::Backend`] if the query fails.
+    /// Returns `Ok(None)` if no session is active.
+    fn capabilities(&self) -> MediaResult<Option<Capabilities>> {
+        Ok(self.get_active_app()?.map(|_| Capabilities::default()))
+    }
 
     /// Starts playback.
     ///
@@ -62,7 +109,7 @@ pub trait MediaSessionBackend: Send + Sync {
     ///
     /// Returns [`MediaError::NoSession`] if no session exists.
     /// Returns [`MediaError::Backend`] if the command fails.
-    async fn play(&self) -> MediaResult<()>;
+    fn play(&self) -> impl Future<Output = MediaResult<()>> + Send;
 
     /// Pauses playback.
     ///
@@ -70,7 +117,7 @@ pub trait MediaSessionBackend: Send + Sync {
     ///
     /// Returns [`MediaError::NoSession`] if no session exists.
     /// Returns [`MediaError::Backend`] if the command fails.
-    async fn pause(&self) -> MediaResult<()>;
+    fn pause(&self) -> impl Future<Output = MediaResult<()>> + Send;
 
     /// Toggles play/pause state.
     ///
@@ -78,7 +125,7 @@ pub trait MediaSessionBackend: Send + Sync {
     ///
     /// Returns [`MediaError::NoSession`] if no session exists.
     /// Returns [`MediaError::Backend`] if the command fails.
-    async fn play_pause(&self) -> MediaResult<()>;
+    fn play_pause(&self) -> impl Future<Output = MediaResult<()>> + Send;
 
     /// Stops playback.
     ///
@@ -86,7 +133,7 @@ pub trait MediaSessionBackend: Send + Sync {
     ///
     /// Returns [`MediaError::NoSession`] if no session exists.
     /// Returns [`MediaError::Backend`] if the command fails.
-    async fn stop(&self) -> MediaResult<()>;
+    fn stop(&self) -> impl Future<Output = MediaResult<()>> + Send;
 
     /// Skips to next track.
     ///
@@ -94,7 +141,7 @@ pub trait MediaSessionBackend: Send + Sync {
     ///
     /// Returns [`MediaError::NoSession`] if no session exists.
     /// Returns [`MediaError::Backend`] if the command fails.
-    async fn next(&self) -> MediaResult<()>;
+    fn next(&self) -> impl Future<Output = MediaResult<()>> + Send;
 
     /// Skips to previous track.
     ///
@@ -102,7 +149,7 @@ pub trait MediaSessionBackend: Send + Sync {
     ///
     /// Returns [`MediaError::NoSession`] if no session exists.
     /// Returns [`MediaError::Backend`] if the command fails.
-    async fn previous(&self) -> MediaResult<()>;
+    fn previous(&self) -> impl Future<Output = MediaResult<()>> + Send;
 
     /// Seeks to the specified position.
     ///
@@ -110,74 +157,365 @@ pub trait MediaSessionBackend: Send + Sync {
     ///
     /// Returns [`MediaError::NoSession`] if no session exists.
     /// Returns [`MediaError::Backend`] if the command fails.
-    async fn seek(&self, position: Duration) -> MediaResult<()>;
+    fn seek(&self, position: Duration) -> impl Future<Output = MediaResult<()>> + Send;
+
+    /// Moves the position by `offset_ms` milliseconds, backwards if
+    /// negative.
+    ///
+    /// The default implementation reads the position with
+    /// [`get_current`](Self::get_current) and then calls
+    /// [`seek`](Self::seek); backends whose platform seeks relative to the
+    /// current position should do so in one call instead.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::NoSession`] if no session exists.
+    /// Returns [`MediaError::Backend`] if the command fails.
+    fn seek_by(&self, offset_ms: i64) -> impl Future<Output = MediaResult<()>> + Send {
+        async move {
+            let info = self.get_current().await?.ok_or(MediaError::NoSession)?;
+            let position = offset_position(info.position.unwrap_or_default(), offset_ms);
+            self.seek(position).await
+        }
+    }
 
     /// Sets the volume level (0.0 to 1.0).
     ///
     /// # Errors
     ///
     /// Returns [`MediaError::Backend`] if the command fails.
-    async fn set_volume(&self, volume: f64) -> MediaResult<()>;
+    fn set_volume(&self, volume: f64) -> impl Future<Output = MediaResult<()>> + Send;
 
     /// Sets the repeat mode.
     ///
     /// # Errors
     ///
     /// Returns [`MediaError::Backend`] if the command fails.
-    async fn set_repeat_mode(&self, mode: RepeatMode) -> MediaResult<()>;
+    fn set_repeat_mode(&self, mode: RepeatMode) -> impl Future<Output = MediaResult<()>> + Send;
 
     /// Sets shuffle mode.
     ///
     /// # Errors
     ///
     /// Returns [`MediaError::Backend`] if the command fails.
-    async fn set_shuffle(&self, enabled: bool) -> MediaResult<()>;
+    fn set_shuffle(&self, enabled: bool) -> impl Future<Output = MediaResult<()>> + Send;
 
-    /// Starts listening for media session events.
+    /// Subscribes to native change notifications.
+    ///
+    /// Backends that can be notified by the OS register for its signals
+    /// here and push [`RawUpdate`]s into `sink` until it is closed; see
+    /// [`EventSink::closed`]. The call itself should return as soon as the
+    /// subscription is in place.
+    ///
+    /// The default implementation returns [`MediaError::NotSupported`],
+    /// in which case the backend is polled with
+    /// [`get_current`](Self::get_current) instead.
+    ///
+    /// [`RawUpdate`]: super::events::RawUpdate
     ///
     /// # Errors
     ///
-    /// Returns [`MediaError::Backend`] if event listening cannot be started.
-    async fn start_listening(
-        &self,
-        tx: mpsc::Sender<MediaResult<MediaSessionEvent>>,
-        debounce_duration: Duration,
-    ) -> MediaResult<()>;
+    /// Returns [`MediaError::NotSupported`] if the backend cannot subscribe.
+    /// Returns [`MediaError::Backend`] if the subscription fails.
+    fn subscribe(&self, sink: EventSink) -> impl Future<Output = MediaResult<()>> + Send {
+        let _ = sink;
+        let platform = self.platform_name();
+        async move { Err(MediaError::NotSupported(platform.to_string())) }
+    }
+}
+
+/// Object-safe mirror of [`MediaSessionBackend`], implemented for every
+/// backend by boxing its futures.
+trait ErasedBackend: Send + Sync {
+    fn platform_name(&self) -> &'static str;
+    fn get_current(&self) -> BoxFuture<'_, MediaResult<Option<MediaInfo>>>;
+    fn get_artwork(&self) -> BoxFuture<'_, MediaResult<Option<Arc<[u8]>>>>;
+    fn artwork_key(&self) -> BoxFuture<'_, MediaResult<Option<u64>>>;
+    fn get_active_app(&self) -> MediaResult<Option<Arc<str>>>;
+    fn capabilities(&self) -> MediaResult<Option<Capabilities>>;
+    fn play(&self) -> BoxFuture<'_, MediaResult<()>>;
+    fn pause(&self) -> BoxFuture<'_, MediaResult<()>>;
+    fn play_pause(&self) -> BoxFuture<'_, MediaResult<()>>;
+    fn stop(&self) -> BoxFuture<'_, MediaResult<()>>;
+    fn next(&self) -> BoxFuture<'_, MediaResult<()>>;
+    fn previous(&self) -> BoxFuture<'_, MediaResult<()>>;
+    fn seek(&self, position: Duration) -> BoxFuture<'_, MediaResult<()>>;
+    fn seek_by(&self, offset_ms: i64) -> BoxFuture<'_, MediaResult<()>>;
+    fn set_volume(&self, volume: f64) -> BoxFuture<'_, MediaResult<()>>;
+    fn set_repeat_mode(&self, mode: RepeatMode) -> BoxFuture<'_, MediaResult<()>>;
+    fn set_shuffle(&self, enabled: bool) -> BoxFuture<'_, MediaResult<()>>;
+    fn subscribe(&self, sink: EventSink) -> BoxFuture<'_, MediaResult<()>>;
+}
+
+impl<B: MediaSessionBackend> ErasedBackend for B {
+    fn platform_name(&self) -> &'static str {
+        MediaSessionBackend::platform_name(self)
+    }
+
+    fn get_current(&self) -> BoxFuture<'_, MediaResult<Option<MediaInfo>>> {
+        Box::pin(MediaSessionBackend::get_current(self))
+    }
+
+    fn get_artwork(&self) -> BoxFuture<'_, MediaResult<Option<Arc<[u8]>>>> {
+        Box::pin(MediaSessionBackend::get_artwork(self))
+    }
+
+    fn artwork_key(&self) -> BoxFuture<'_, MediaResult<Option<u64>>> {
+        Box::pin(MediaSessionBackend::artwork_key(self))
+    }
+
+    fn get_active_app(&self) -> MediaResult<Option<Arc<str>>> {
+        MediaSessionBackend::get_active_app(self)
+    }
+
+    fn capabilities(&self) -> MediaResult<Option<Capabilities>> {
+        MediaSessionBackend::capabilities(self)
+    }
+
+    fn play(&self) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::play(self))
+    }
+
+    fn pause(&self) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::pause(self))
+    }
+
+    fn play_pause(&self) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::play_pause(self))
+    }
+
+    fn stop(&self) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::stop(self))
+    }
+
+    fn next(&self) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::next(self))
+    }
+
+    fn previous(&self) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::previous(self))
+    }
+
+    fn seek(&self, position: Duration) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::seek(self, position))
+    }
+
+    fn seek_by(&self, offset_ms: i64) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::seek_by(self, offset_ms))
+    }
+
+    fn set_volume(&self, volume: f64) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::set_volume(self, volume))
+    }
+
+    fn set_repeat_mode(&self, mode: RepeatMode) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::set_repeat_mode(self, mode))
+    }
+
+    fn set_shuffle(&self, enabled: bool) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::set_shuffle(self, enabled))
+    }
+
+    fn subscribe(&self, sink: EventSink) -> BoxFuture<'_, MediaResult<()>> {
+        Box::pin(MediaSessionBackend::subscribe(self, sink))
+    }
+}
+
+/// Type-erased [`MediaSessionBackend`].
+///
+/// This is the default backend type of [`MediaSessions`](crate::MediaSessions):
+/// it holds the platform backend, or any backend passed to
+/// [`MediaSessionsBuilder::backend`](crate::MediaSessionsBuilder::backend).
+/// Every call boxes the backend's future; build with
+/// [`MediaSessionsBuilder::build_with`](crate::MediaSessionsBuilder::build_with)
+/// to call a concrete backend type without that allocation.
+///
+/// Clones share the same backend.
+#[derive(Clone)]
+pub struct DynBackend(Arc<dyn ErasedBackend>);
+
+impl DynBackend {
+    /// Erases the type of `backend`.
+    pub fn new(backend: impl MediaSessionBackend) -> Self {
+        Self(Arc::new(backend))
+    }
+}
+
+impl std::fmt::Debug for DynBackend {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_tuple("DynBackend")
+            .field(&self.0.platform_name())
+            .finish()
+    }
+}
+
+impl MediaSessionBackend for DynBackend {
+    fn platform_name(&self) -> &'static str {
+        self.0.platform_name()
+    }
+
+    fn get_current(&self) -> impl Future<Output = MediaResult<Option<MediaInfo>>> + Send {
+        self.0.get_current()
+    }
+
+    fn get_artwork(&self) -> impl Future<Output = MediaResult<Option<Arc<[u8]>>>> + Send {
+        self.0.get_artwork()
+    }
+
+    fn artwork_key(&self) -> impl Future<Output = MediaResult<Option<u64>>> + Send {
+        self.0.artwork_key()
+    }
+
+    fn get_active_app(&self) -> MediaResult<Option<Arc<str>>> {
+        self.0.get_active_app()
+    }
+
+    fn capabilities(&self) -> MediaResult<Option<Capabilities>> {
+        self.0.capabilities()
+    }
+
+    fn play(&self) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.play()
+    }
+
+    fn pause(&self) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.pause()
+    }
+
+    fn play_pause(&self) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.play_pause()
+    }
+
+    fn stop(&self) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.stop()
+    }
+
+    fn next(&self) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.next()
+    }
+
+    fn previous(&self) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.previous()
+    }
+
+    fn seek(&self, position: Duration) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.seek(position)
+    }
+
+    fn seek_by(&self, offset_ms: i64) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.seek_by(offset_ms)
+    }
+
+    fn set_volume(&self, volume: f64) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.set_volume(volume)
+    }
+
+    fn set_repeat_mode(&self, mode: RepeatMode) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.set_repeat_mode(mode)
+    }
+
+    fn set_shuffle(&self, enabled: bool) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.set_shuffle(enabled)
+    }
+
+    fn subscribe(&self, sink: EventSink) -> impl Future<Output = MediaResult<()>> + Send {
+        self.0.subscribe(sink)
+    }
+}
+
+/// Returns `position` moved by `offset_ms` milliseconds, stopping at zero.
+const fn offset_position(position: Duration, offset_ms: i64) -> Duration {
+    let offset = Duration::from_millis(offset_ms.unsigned_abs());
+    if offset_ms < 0 {
+        position.saturating_sub(offset)
+    } else {
+        position.saturating_add(offset)
+    }
 }
 
 /// Creates the appropriate backend for the current platform.
 ///
 /// This factory function selects and instantiates the correct
-/// platform-specific backend implementation at runtime.
+/// platform-specific backend implementation at runtime. Background
+/// tasks of the backend are spawned on `runtime`.
 ///
 /// # Errors
 ///
 /// Returns [`MediaError::NotSupported`] if the current platform
 /// is not supported by this crate.
-pub fn create_backend() -> MediaResult<Box<dyn MediaSessionBackend>> {
+pub fn create_backend(runtime: &Handle) -> MediaResult<DynBackend> {
     #[cfg(target_os = "windows")]
     {
-        return Ok(Box::new(
-            crate::platform::windows_backend::WindowsBackend::new()?,
+        return Ok(DynBackend::new(
+            crate::platform::windows_backend::WindowsBackend::new(runtime.clone())?,
         ));
     }
 
     #[cfg(target_os = "macos")]
     {
-        return Ok(Box::new(
-            crate::platform::macos_backend::MacOSBackend::new()?
+        return Ok(DynBackend::new(
+            crate::platform::macos_backend::MacOSBackend::new(runtime.clone())?,
         ));
     }
 
     #[cfg(target_os = "linux")]
     {
-        return Ok(Box::new(
-            crate::platform::linux_backend::LinuxBackend::new()?
+        return Ok(DynBackend::new(
+            crate::platform::linux_backend::LinuxBackend::new(runtime.clone())?,
         ));
     }
 
     #[allow(unreachable_code)]
-    Err(MediaError::NotSupported(std::env::consts::OS.to_string()))
+    {
+        let _ = runtime;
+        Err(MediaError::NotSupported(std::env::consts::OS.to_string()))
+    }
+}
+
+/// Creates the backend for the current platform without blocking the
+/// calling task.
+///
+/// The Linux backend connects on the caller's runtime; the Windows session
+/// manager, which can only be requested synchronously, is requested on the
+/// blocking pool of `runtime`.
+///
+/// # Errors
+///
+/// Returns [`MediaError::NotSupported`] if the current platform
+/// is not supported by this crate.
+pub async fn create_backend_async(runtime: &Handle) -> MediaResult<DynBackend> {
+    #[cfg(target_os = "windows")]
+    {
+        let handle = runtime.clone();
+        let backend = runtime
+            .spawn_blocking(move || crate::platform::windows_backend::WindowsBackend::new(handle))
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })??;
+        return Ok(DynBackend::new(backend));
+    }
+
+    #[cfg(target_os = "macos")]
+    {
+        return Ok(DynBackend::new(
+            crate::platform::macos_backend::MacOSBackend::new(runtime.clone())?,
+        ));
+    }
+
+    #[cfg(target_os = "linux")]
+    {
+        return Ok(DynBackend::new(
+            crate::platform::linux_backend::LinuxBackend::new_async(runtime.clone()).await?,
+        ));
+    }
+
+    #[allow(unreachable_code)]
+    {
+        let _ = runtime;
+        Err(MediaError::NotSupported(std::env::consts::OS.to_string()))
+    }
 }
 
 /// Helper for debouncing rapid events.
@@ -0,0 +1,172 @@
+//! Raw change notifications pushed by backends.
+//!
+//! Backends that can subscribe to native OS notifications push
+//! [`RawUpdate`]s into an [`EventSink`] from whatever thread the OS calls
+//! them on. A single pipeline task per [`watch`](crate::MediaSessions::watch)
+//! stream turns them into [`MediaSessionEvent`](crate::MediaSessionEvent)s:
+//! it tracks the session state, diffs it, and applies the debounce.
+//!
+//! Backends without native notifications do not implement
+//! [`MediaSessionBackend::subscribe`](super::MediaSessionBackend::subscribe)
+//! at all; the pipeline then polls them instead.
+
+use std::sync::Arc;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::Duration;
+
+use tokio::sync::mpsc;
+
+use crate::error::MediaError;
+use crate::media_info::{MediaInfo, PlaybackStatus};
+use crate::media_sessions::RepeatMode;
+
+/// A single change reported by a backend.
+///
+/// Updates may be partial: a backend only reports what it was told by the
+/// OS. Whenever it cannot tell what changed, it sends
+/// [`RawUpdate::Invalidated`] and the pipeline re-reads the full state.
+#[derive(Debug, Clone)]
+#[non_exhaustive]
+pub enum RawUpdate {
+    /// Full state of the active session, or `None` if there is none.
+    Snapshot(Option<MediaInfo>),
+    /// Track metadata changed.
+    ///
+    /// Only the track fields are used; playback status and position are
+    /// taken from the last known state.
+    Metadata(MediaInfo),
+    /// Playback status changed.
+    PlaybackStatus(PlaybackStatus),
+    /// Playback position changed, e.g. after a seek.
+    Position(Duration),
+    /// The player seeked.
+    ///
+    /// Unlike [`Position`](Self::Position), this is always reported as
+    /// [`MediaSessionEvent::PositionChanged`](crate::MediaSessionEvent::PositionChanged),
+    /// however short the jump.
+    Seeked {
+        /// Position after the seek.
+        position: Duration,
+        /// Position just before the seek, if the backend knows it.
+        old_position: Option<Duration>,
+    },
+    /// Volume changed (0.0 to 1.0).
+    Volume(f64),
+    /// Repeat mode changed.
+    RepeatMode(RepeatMode),
+    /// Shuffle was turned on or off.
+    Shuffle(bool),
+    /// Artwork changed.
+    ArtworkChanged,
+    /// A player became the active session.
+    SessionOpened {
+        /// Name of the media player application.
+        app_name: String,
+    },
+    /// The active session closed.
+    SessionClosed,
+    /// Something changed, but the backend cannot tell what.
+    Invalidated,
+    /// The subscription failed; the error is passed on to the stream.
+    Error(MediaError),
+}
+
+/// Sending half of a raw update channel, handed to
+/// [`MediaSessionBackend::subscribe`](super::MediaSessionBackend::subscribe).
+///
+/// Pushing never blocks, so it is safe to call from OS callback threads.
+/// If the pipeline falls behind, updates are dropped and the pipeline
+/// re-reads the full state once it catches up, so no change is lost.
+#[derive(Debug, Clone)]
+pub struct EventSink {
+    tx: mpsc::Sender<RawUpdate>,
+    dropped: Arc<AtomicU64>,
+}
+
+impl EventSink {
+    /// Pushes an update without blocking.
+    ///
+    /// Returns `false` once the pipeline is gone; the backend should then
+    /// release its OS subscription.
+    #[must_use]
+    pub fn push(&self, update: RawUpdate) -> bool {
+        match self.tx.try_send(update) {
+            Ok(()) => true,
+            Err(mpsc::error::TrySendError::Full(_)) => {
+                self.dropped.fetch_add(1, Ordering::Release);
+                true
+            }
+            Err(mpsc::error::TrySendError::Closed(_)) => false,
+        }
+    }
+
+    /// Returns `true` once the pipeline is gone.
+    #[must_use]
+    pub fn is_closed(&self) -> bool {
+        self.tx.is_closed()
+    }
+
+    /// Completes once the pipeline is gone.
+    pub async fn closed(&self) {
+        self.tx.closed().await;
+    }
+}
+
+/// Receiving half of a raw update channel, owned by the pipeline.
+#[derive(Debug)]
+pub(crate) struct RawUpdates {
+    rx: mpsc::Receiver<RawUpdate>,
+    dropped: Arc<AtomicU64>,
+}
+
+impl RawUpdates {
+    /// Receives the next update; `None` once every sink is dropped.
+    pub(crate) async fn recv(&mut self) -> Option<RawUpdate> {
+        self.rx.recv().await
+    }
+
+    /// Returns the number of updates dropped since the last call.
+    pub(crate) fn take_dropped(&self) -> u64 {
+        self.dropped.swap(0, Ordering::Acquire)
+    }
+}
+
+/// Creates a raw update channel holding up to `capacity` updates.
+pub(crate) fn channel(capacity: usize) -> (EventSink, RawUpdates) {
+    let (tx, rx) = mpsc::channel(capacity);
+    let dropped = Arc::new(AtomicU64::new(0));
+    (
+        EventSink {
+            tx,
+            dropped: Arc::clone(&dropped),
+        },
+        RawUpdates { rx, dropped },
+    )
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[tokio::test]
+    async fn test_overflow_is_counted() {
+        let (sink, mut updates) = channel(1);
+
+        assert!(sink.push(RawUpdate::Invalidated));
+        assert!(sink.push(RawUpdate::SessionClosed));
+        assert!(sink.push(RawUpdate::SessionClosed));
+        assert_eq!(updates.take_dropped(), 2);
+        assert_eq!(updates.take_dropped(), 0);
+
+        assert!(matches!(updates.recv().await, Some(RawUpdate::Invalidated)));
+    }
+
+    #[test]
+    fn test_push_after_close() {
+        let (sink, updates) = channel(4);
+        drop(updates);
+
+        assert!(sink.is_closed());
+        assert!(!sink.push(RawUpdate::Invalidated));
+    }
+}
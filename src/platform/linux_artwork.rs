@@ -0,0 +1,243 @@
+//! Artwork loaded from local files.
+//!
+//! Most local players (mpv, Rhythmbox, Firefox) point `mpris:artUrl` at a
+//! `file://` URI in their cache directory. Such files are read once and
+//! kept in memory while their modification time and size are unchanged
+//! and the track stays the same, so asking for the same cover again costs
+//! a single `stat` and hands out the same shared bytes.
+//!
+//! The track matters because players often rewrite one fixed cache path,
+//! such as `cover.jpg`, for every track. A rewrite within the resolution
+//! of the modification time, with an image of the same size, looks
+//! unchanged to `stat`; a new track still reads the file again.
+//!
+//! Files are read rather than memory-mapped: a player truncating its cache
+//! file while a mapping of it is read would crash the host process with
+//! `SIGBUS`.
+
+use std::ffi::OsString;
+use std::hash::{DefaultHasher, Hash, Hasher};
+use std::io;
+use std::os::unix::ffi::OsStringExt;
+use std::path::{Path, PathBuf};
+use std::sync::{Arc, Mutex, PoisonError};
+use std::time::SystemTime;
+
+/// Number of files kept in memory.
+const CAPACITY: usize = 8;
+
+/// Total size of the files kept in memory.
+const BUDGET: u64 = 32 * 1024 * 1024;
+
+/// Largest artwork file that is loaded.
+const MAX_FILE_SIZE: u64 = 32 * 1024 * 1024;
+
+/// A loaded artwork file.
+#[derive(Debug)]
+struct Entry {
+    path: PathBuf,
+    /// Track the file was read for.
+    track: Option<Box<str>>,
+    modified: Option<SystemTime>,
+    len: u64,
+    bytes: Arc<[u8]>,
+}
+
+/// Loaded artwork files, shared by all backends on one bus connection.
+#[derive(Debug, Default)]
+pub struct ArtworkFiles {
+    /// Loaded files, least recently used first.
+    entries: Mutex<Vec<Entry>>,
+}
+
+impl ArtworkFiles {
+    /// Returns the contents of the file at `path`, the cover of `track`.
+    ///
+    /// The file is only read again if it changed since the last call or is
+    /// asked for with another track; otherwise the bytes of that call are
+    /// returned. Returns `None` for empty files and files too large to be
+    /// artwork. This blocks on file I/O, so call it on a blocking thread.
+    pub(crate) fn load(&self, path: &Path, track: Option<&str>) -> io::Result<Option<Arc<[u8]>>> {
+        let metadata = std::fs::metadata(path)?;
+        let modified = metadata.modified().ok();
+        let len = metadata.len();
+        if len == 0 || len > MAX_FILE_SIZE {
+            return Ok(None);
+        }
+
+        {
+            let mut entries = self.entries.lock().unwrap_or_else(PoisonError::into_inner);
+            if let Some(index) = entries.iter().position(|entry| entry.path == path) {
+                let entry = entries.remove(index);
+                if entry.modified == modified && entry.len == len && entry.track.as_deref() == track
+                {
+                    let bytes = Arc::clone(&entry.bytes);
+                    entries.push(entry);
+                    drop(entries);
+                    return Ok(Some(bytes));
+                }
+            }
+        }
+
+        // The file may change between `stat` and the read; the bytes are
+        // then kept under the old key and replaced on the next call.
+        let bytes: Arc<[u8]> = std::fs::read(path)?.into();
+        if bytes.is_empty() {
+            return Ok(None);
+        }
+
+        let mut entries = self.entries.lock().unwrap_or_else(PoisonError::into_inner);
+        entries.retain(|entry| entry.path != path);
+        entries.push(Entry {
+            path: path.to_path_buf(),
+            track: track.map(Box::from),
+            modified,
+            len,
+            bytes: Arc::clone(&bytes),
+        });
+        let mut used: u64 = entries.iter().map(|entry| entry.len).sum();
+        while entries.len() > CAPACITY || (used > BUDGET && entries.len() > 1) {
+            used -= entries.remove(0).len;
+        }
+        drop(entries);
+        Ok(Some(bytes))
+    }
+}
+
+/// Returns a key for the file at `path`, the cover of `track`, that
+/// changes whenever its contents may have: it covers the track, path,
+/// modification time and size.
+///
+/// This costs a single `stat`, which blocks, so call it on a blocking
+/// thread.
+pub fn file_key(path: &Path, track: Option<&str>) -> io::Result<u64> {
+    let metadata = std::fs::metadata(path)?;
+    let mut hasher = DefaultHasher::new();
+    track.hash(&mut hasher);
+    path.hash(&mut hasher);
+    metadata.modified().ok().hash(&mut hasher);
+    metadata.len().hash(&mut hasher);
+    Ok(hasher.finish())
+}
+
+/// Converts a local `file://` URL into a path, decoding percent escapes.
+///
+/// Returns `None` for other URLs.
+pub fn file_url_path(url: &str) -> Option<PathBuf> {
+    let path = url.strip_prefix("file://")?;
+    let path = path.strip_prefix("localhost").unwrap_or(path);
+    if !path.starts_with('/') {
+        return None;
+    }
+
+    let mut bytes = Vec::with_capacity(path.len());
+    let mut rest = path.as_bytes();
+    while let [first, tail @ ..] = rest {
+        if let (b'%', [high, low, after @ ..]) = (first, tail) {
+            if let (Some(high), Some(low)) = (hex(*high), hex(*low)) {
+                bytes.push((high << 4) | low);
+                rest = after;
+                continue;
+            }
+        }
+        bytes.push(*first);
+        rest = tail;
+    }
+    Some(PathBuf::from(OsString::from_vec(bytes)))
+}
+
+/// Decodes a single hex digit.
+const fn hex(digit: u8) -> Option<u8> {
+    match digit {
+        b'0'..=b'9' => Some(digit - b'0'),
+        b'a'..=b'f' => Some(digit - b'a' + 10),
+        b'A'..=b'F' => Some(digit - b'A' + 10),
+        _ => None,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_file_url_path() {
+        assert_eq!(
+            file_url_path("file:///home/user/.cache/cover%20art.jpg"),
+            Some(PathBuf::from("/home/user/.cache/cover art.jpg"))
+        );
+        assert_eq!(
+            file_url_path("file://localhost/tmp/a.png"),
+            Some(PathBuf::from("/tmp/a.png"))
+        );
+        assert_eq!(
+            file_url_path("file:///tmp/100%.png"),
+            Some(PathBuf::from("/tmp/100%.png"))
+        );
+        assert_eq!(file_url_path("https://example.com/a.png"), None);
+        assert_eq!(file_url_path("file://host/a.png"), None);
+    }
+
+    #[test]
+    fn test_unchanged_file_is_read_once() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("cover.jpg");
+        std::fs::write(&path, b"first").unwrap();
+
+        let files = ArtworkFiles::default();
+        let first = files.load(&path, None).unwrap().unwrap();
+        let again = files.load(&path, None).unwrap().unwrap();
+        assert!(Arc::ptr_eq(&first, &again));
+        assert_eq!(&first[..], b"first");
+
+        std::fs::write(&path, b"second!").unwrap();
+        let changed = files.load(&path, None).unwrap().unwrap();
+        assert_eq!(&changed[..], b"second!");
+
+        std::fs::write(&path, b"").unwrap();
+        assert!(files.load(&path, None).unwrap().is_none());
+    }
+
+    #[test]
+    fn test_file_key_follows_changes() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("cover.jpg");
+        std::fs::write(&path, b"first").unwrap();
+
+        let key = file_key(&path, None).unwrap();
+        assert_eq!(file_key(&path, None).unwrap(), key);
+
+        std::fs::write(&path, b"second!").unwrap();
+        assert_ne!(file_key(&path, None).unwrap(), key);
+
+        std::fs::remove_file(&path).unwrap();
+        assert!(file_key(&path, None).is_err());
+    }
+
+    #[test]
+    fn test_new_track_reads_rewritten_file_again() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("cover.jpg");
+        std::fs::write(&path, b"first").unwrap();
+        let modified = std::fs::metadata(&path).unwrap().modified().unwrap();
+
+        let files = ArtworkFiles::default();
+        let key = file_key(&path, Some("/track/1")).unwrap();
+        let first = files.load(&path, Some("/track/1")).unwrap().unwrap();
+        assert_eq!(&first[..], b"first");
+
+        // Rewritten for the next track within one modification time tick,
+        // with an image of the same size.
+        std::fs::write(&path, b"other").unwrap();
+        std::fs::File::options()
+            .write(true)
+            .open(&path)
+            .unwrap()
+            .set_modified(modified)
+            .unwrap();
+
+        assert_ne!(file_key(&path, Some("/track/2")).unwrap(), key);
+        let next = files.load(&path, Some("/track/2")).unwrap().unwrap();
+        assert_eq!(&next[..], b"other");
+    }
+}
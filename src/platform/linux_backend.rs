@@ -8,64 +8,750 @@
 //! - D-Bus session bus running
 //! - MPRIS-compatible media player (Spotify, Firefox, mpv, etc.)
 //! - The `zbus` crate for async D-Bus communication
+//!
+//! # Events
+//!
+//! Changes are pushed by the players themselves: the backend adds exact
+//! match rules for `PropertiesChanged` and `Seeked` on the MPRIS object
+//! path, and a single task per backend applies the signal payloads to its
+//! player registry and passes them on to every subscription. Nothing goes
+//! over the bus while the player is idle.
+//!
+//! Players coming and going are tracked the same way, through
+//! `NameOwnerChanged` signals for the MPRIS name namespace. The bus is
+//! listed only once, when the backend is created.
+//!
+//! # Connection
+//!
+//! Backends created with [`LinuxBackend::new`] share one connection, player
+//! registry and signal task per process, so creating one after the first
+//! costs no bus traffic. [`LinuxBackend::with_private_connection`] opens a
+//! connection of its own, and [`LinuxBackend::with_connection`] uses one
+//! it is given.
+//!
+//! The signal task publishes the active player's name, owner and proxy by
+//! swapping one `Arc`, so reading the active application and finding the
+//! proxy for a control call never take a lock.
+//!
+//! # Position
+//!
+//! Players do not signal `Position` while playing. The backend models it
+//! instead: from the last reported position, it advances at `Rate` while
+//! the player is playing, and `Seeked` signals move it. Once a player's
+//! properties have been read, [`get_current`](MediaSessionBackend::get_current)
+//! is answered from the registry without a D-Bus call.
 
-use std::sync::Arc;
-use std::time::Duration;
+use std::collections::HashMap;
+use std::hash::{DefaultHasher, Hash, Hasher};
+use std::path::PathBuf;
+use std::sync::{Arc, Mutex, MutexGuard, OnceLock, PoisonError, Weak};
+use std::time::{Duration, Instant};
 
-use tokio::sync::{RwLock, mpsc};
+use arc_swap::{ArcSwap, ArcSwapOption};
+use futures::{Stream, StreamExt};
+use tokio::runtime::Handle;
+use tokio::sync::watch;
+use zbus::zvariant::Value;
 
 use super::backend::MediaSessionBackend;
+use super::events::{EventSink, RawUpdate};
+use super::linux_artwork::{ArtworkFiles, file_key, file_url_path};
 use crate::error::{MediaError, MediaResult};
-use crate::media_info::{MediaInfo, PlaybackStatus};
-use crate::media_sessions::{MediaSessionEvent, RepeatMode};
+use crate::media_info::{Capabilities, MediaInfo, PlaybackStatus};
+use crate::media_sessions::RepeatMode;
 
 /// MPRIS service name prefix.
 const MPRIS_SERVICE_PREFIX: &str = "org.mpris.MediaPlayer2.";
 
+/// Namespace of all MPRIS service names.
+const MPRIS_NAMESPACE: &str = "org.mpris.MediaPlayer2";
+
+/// Name and interface of the message bus itself.
+const BUS_NAME: &str = "org.freedesktop.DBus";
+
+/// Object path of the message bus.
+const BUS_PATH: &str = "/org/freedesktop/DBus";
+
 /// MPRIS object path.
 const MPRIS_PATH: &str = "/org/mpris/MediaPlayer2";
 
 /// MPRIS player interface.
 const MPRIS_PLAYER_INTERFACE: &str = "org.mpris.MediaPlayer2.Player";
 
-/// Linux MPRIS backend.
-#[derive(Clone, Debug)]
-pub struct LinuxBackend {
-    connection: Option<zbus::Connection>,
-    player_name: Arc<RwLock<Option<String>>>,
+/// Interface of the `PropertiesChanged` signal.
+const PROPERTIES_INTERFACE: &str = "org.freedesktop.DBus.Properties";
+
+/// `mpris:trackid` of a player without a track.
+const NO_TRACK: &str = "/org/mpris/MediaPlayer2/TrackList/NoTrack";
+
+/// Signals zbus queues before the subscription task reads them.
+const SIGNAL_QUEUE: usize = 64;
+
+/// Records a `Can*` property in `capabilities`. Other properties are
+/// ignored.
+fn set_capability(capabilities: &mut Capabilities, property: &str, can: bool) {
+    let flag = match property {
+        "CanPlay" => &mut capabilities.can_play,
+        "CanPause" => &mut capabilities.can_pause,
+        "CanSeek" => &mut capabilities.can_seek,
+        "CanGoNext" => &mut capabilities.can_go_next,
+        "CanGoPrevious" => &mut capabilities.can_go_previous,
+        "CanControl" => &mut capabilities.can_control,
+        _ => return,
+    };
+    *flag = can;
 }
 
-impl LinuxBackend {
-    /// Creates a new Linux backend instance.
-    pub fn new() -> MediaResult<Self> {
-        match tokio::runtime::Handle::try_current() {
-            Ok(handle) => handle.block_on(Self::new_async()),
-            Err(_) => {
-                let rt = tokio::runtime::Runtime::new().map_err(|e| MediaError::Backend {
-                    platform: "linux".to_string(),
-                    message: format!("Failed to create runtime: {e}"),
-                })?;
-                rt.block_on(Self::new_async())
+/// Player properties that do not fit in [`MediaInfo`], kept current by
+/// `PropertiesChanged` signals.
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+struct PlayerState {
+    volume: Option<f64>,
+    repeat: Option<RepeatMode>,
+    shuffle: Option<bool>,
+    rate: Option<f64>,
+    capabilities: Capabilities,
+}
+
+impl PlayerState {
+    /// Fails with [`MediaError::NotSupported`] if the player does not
+    /// accept a command, according to its `Can*` properties.
+    fn require(&self, supported: impl FnOnce(&Capabilities) -> bool) -> MediaResult<()> {
+        if supported(&self.capabilities) {
+            Ok(())
+        } else {
+            Err(MediaError::NotSupported("linux".to_string()))
+        }
+    }
+}
+
+/// Playback position, extrapolated from the last one reported.
+#[derive(Debug, Clone, Copy, PartialEq)]
+struct PositionModel {
+    /// Position at `at`.
+    position: Duration,
+    at: Instant,
+    /// Speed at which the position advances: the playback rate while
+    /// playing, zero otherwise.
+    rate: f64,
+}
+
+impl PositionModel {
+    /// Returns the position at `now`.
+    fn at(&self, now: Instant) -> Duration {
+        let elapsed = now.saturating_duration_since(self.at).as_secs_f64();
+        // A rate that is not a number leaves the position where it was.
+        let moved = Duration::try_from_secs_f64(elapsed * self.rate.abs()).unwrap_or_default();
+        if self.rate < 0.0 {
+            self.position.saturating_sub(moved)
+        } else {
+            self.position.saturating_add(moved)
+        }
+    }
+}
+
+/// How to move a player to a position in one call.
+#[derive(Debug, Clone, PartialEq, Eq)]
+enum SeekTarget {
+    /// `SetPosition` on the track with this `mpris:trackid`.
+    Track(String),
+    /// `Seek` by this many microseconds.
+    Offset(i64),
+}
+
+/// A known MPRIS player.
+#[derive(Debug)]
+struct Player {
+    /// Well-known service name, e.g. `org.mpris.MediaPlayer2.spotify`.
+    name: String,
+    /// Unique name of the connection currently owning `name`.
+    owner: String,
+    /// State as of the last full read.
+    state: PlayerState,
+    /// Track fields of the last metadata seen.
+    track: MediaInfo,
+    /// `mpris:trackid` of the last metadata seen.
+    track_id: Option<Arc<str>>,
+    /// Fingerprint of the last `Metadata` payload seen.
+    metadata_fingerprint: Option<u64>,
+    /// Playback status as last reported.
+    status: PlaybackStatus,
+    /// Playback position, if the player reported one.
+    position: Option<PositionModel>,
+    /// Whether the fields above are current: set by a full read, cleared
+    /// when the player changes track or invalidates a property.
+    synced: bool,
+}
+
+impl Player {
+    fn new(name: &str, owner: &str) -> Self {
+        Self {
+            name: name.to_string(),
+            owner: owner.to_string(),
+            state: PlayerState::default(),
+            track: MediaInfo::default(),
+            track_id: None,
+            metadata_fingerprint: None,
+            status: PlaybackStatus::default(),
+            position: None,
+            synced: false,
+        }
+    }
+
+    /// Returns the session as known locally, or `None` if it has to be
+    /// read from the player.
+    fn session(&self, now: Instant) -> Option<MediaInfo> {
+        self.synced.then(|| MediaInfo {
+            playback_status: self.status,
+            position: self.position_at(now),
+            ..self.track.clone()
+        })
+    }
+
+    /// Returns the extrapolated playback position at `now`, capped at the
+    /// track length.
+    fn position_at(&self, now: Instant) -> Option<Duration> {
+        let position = self.position?.at(now);
+        Some(
+            self.track
+                .duration
+                .map_or(position, |length| position.min(length)),
+        )
+    }
+
+    /// Returns how to move to `position` without reading anything from
+    /// the player: with `SetPosition` on the current track if its id is
+    /// known, or else with a relative `Seek` from the modelled position.
+    fn seek_target(&self, position: Duration, now: Instant) -> Option<SeekTarget> {
+        if let Some(track_id) = self.track_id.as_deref().filter(|id| *id != NO_TRACK) {
+            return Some(SeekTarget::Track(track_id.to_string()));
+        }
+        let current = self.session(now)?.position?;
+        Some(SeekTarget::Offset(
+            to_micros(position).saturating_sub(to_micros(current)),
+        ))
+    }
+
+    /// Restarts the position model at `position`.
+    fn set_position(&mut self, position: Duration, now: Instant) {
+        let rate = if self.status == PlaybackStatus::Playing {
+            self.state.rate.unwrap_or(1.0)
+        } else {
+            0.0
+        };
+        self.position = Some(PositionModel {
+            position,
+            at: now,
+            rate,
+        });
+    }
+
+    /// Applies `change` to the playback status or rate, carrying the
+    /// position over to the new speed.
+    fn change_speed(&mut self, now: Instant, change: impl FnOnce(&mut Self)) {
+        let position = self.position_at(now);
+        change(self);
+        if let Some(position) = position {
+            self.set_position(position, now);
+        }
+    }
+
+    /// Takes over a `Metadata` payload as the current track, or clears the
+    /// track if there is none.
+    ///
+    /// A payload identical to the last one is not decoded at all. Returns
+    /// `true` if anything changed.
+    fn update_metadata(&mut self, metadata: Option<&Value<'_>>) -> bool {
+        let fingerprint = metadata.map(fingerprint);
+        if fingerprint.is_some() && fingerprint == self.metadata_fingerprint {
+            return false;
+        }
+        self.metadata_fingerprint = fingerprint;
+
+        match metadata {
+            Some(metadata) => self.update_track(&Metadata::decode(metadata)),
+            None => self.update_track(&Metadata::default()),
+        }
+    }
+
+    /// Takes over `metadata` as the current track.
+    ///
+    /// Only fields whose value differs are reallocated. Returns `true` if
+    /// anything changed.
+    fn update_track(&mut self, metadata: &Metadata<'_>) -> bool {
+        let track_changed = metadata.update(&mut self.track);
+        let id_changed = assign_str(&mut self.track_id, metadata.track_id);
+        track_changed || id_changed
+    }
+}
+
+/// Track metadata, borrowed from the message it was decoded from.
+#[derive(Debug, Default)]
+struct Metadata<'v> {
+    track_id: Option<&'v str>,
+    title: Option<&'v str>,
+    artists: Option<&'v Value<'v>>,
+    album: Option<&'v str>,
+    genres: Option<&'v Value<'v>>,
+    url: Option<&'v str>,
+    art_url: Option<&'v str>,
+    length: Option<Duration>,
+    track_number: Option<u32>,
+    disc_number: Option<u32>,
+    year: Option<i32>,
+}
+
+impl<'v> Metadata<'v> {
+    /// Decodes an MPRIS `Metadata` dictionary without copying any strings.
+    fn decode(metadata: &'v Value<'v>) -> Self {
+        let mut decoded = Self::default();
+        let Value::Dict(dict) = variant(metadata) else {
+            return decoded;
+        };
+
+        for (key, value) in dict.iter() {
+            let Some(key) = string(key) else {
+                continue;
+            };
+            let value = variant(value);
+
+            match key {
+                "mpris:trackid" => decoded.track_id = string(value),
+                "xesam:title" => decoded.title = string(value),
+                "xesam:artist" => decoded.artists = Some(value),
+                "xesam:album" => decoded.album = string(value),
+                "xesam:genre" => decoded.genres = Some(value),
+                "xesam:url" => decoded.url = string(value),
+                "mpris:artUrl" => decoded.art_url = string(value),
+                "mpris:length" => decoded.length = micros(value),
+                "xesam:trackNumber" => {
+                    decoded.track_number = integer(value).and_then(|n| u32::try_from(n).ok());
+                }
+                "xesam:discNumber" => {
+                    decoded.disc_number = integer(value).and_then(|n| u32::try_from(n).ok());
+                }
+                // An ISO 8601 date, of which only the year is kept.
+                "xesam:contentCreated" => {
+                    decoded.year = string(value)
+                        .and_then(|date| date.get(..4))
+                        .and_then(|year| year.parse().ok());
+                }
+                _ => {}
+            }
+        }
+
+        decoded
+    }
+
+    /// Writes the track fields into `info`, leaving playback status and
+    /// position alone.
+    ///
+    /// Only fields whose value differs are reallocated. Returns `true` if
+    /// anything changed.
+    fn update(&self, info: &mut MediaInfo) -> bool {
+        let mut changed = false;
+        changed |= assign_str(&mut info.title, self.title);
+        changed |= assign_list(&mut info.artist, self.artists);
+        changed |= assign_str(&mut info.album, self.album);
+        changed |= assign_list(&mut info.genre, self.genres);
+        changed |= assign_str(&mut info.url, self.url);
+        changed |= assign_str(&mut info.thumbnail_url, self.art_url);
+        changed |= assign(&mut info.duration, self.length);
+        changed |= assign(&mut info.track_number, self.track_number);
+        changed |= assign(&mut info.disc_number, self.disc_number);
+        changed |= assign(&mut info.year, self.year);
+        changed
+    }
+}
+
+/// Sinks of the live subscriptions.
+#[derive(Debug, Default)]
+struct Subscribers {
+    sinks: Vec<EventSink>,
+    /// Set once the signal task has ended; new sinks are then dropped, so
+    /// their pipelines fall back to polling.
+    closed: bool,
+}
+
+impl Subscribers {
+    /// Adds the sink of a new subscription.
+    fn add(&mut self, sink: EventSink) {
+        if !self.closed {
+            self.sinks.push(sink);
+        }
+    }
+
+    /// Pushes `update` to every subscription, forgetting the ones whose
+    /// pipeline is gone.
+    fn push(&mut self, update: &RawUpdate) {
+        self.sinks.retain(|sink| sink.push(update.clone()));
+    }
+
+    /// Drops every sink for good.
+    fn close(&mut self) {
+        self.closed = true;
+        self.sinks.clear();
+    }
+}
+
+/// MPRIS players on the bus, kept current by their signals.
+#[derive(Debug, Default)]
+struct PlayerRegistry {
+    /// Known players, oldest first. The oldest player is the active one.
+    players: Vec<Player>,
+    /// Subscriptions receiving the updates of the active player.
+    subscribers: Subscribers,
+}
+
+impl PlayerRegistry {
+    /// Records that `name` is now owned by `owner`; an empty `owner` means
+    /// the name was released.
+    ///
+    /// Returns `true` if the active player changed.
+    fn set_owner(&mut self, name: &str, owner: &str) -> bool {
+        if !name.starts_with(MPRIS_SERVICE_PREFIX) {
+            return false;
+        }
+
+        let index = self.players.iter().position(|player| player.name == name);
+        match (index, owner.is_empty()) {
+            (Some(index), true) => {
+                self.players.remove(index);
+                index == 0
+            }
+            (Some(index), false) => {
+                self.players[index] = Player::new(name, owner);
+                index == 0
+            }
+            (None, false) => {
+                self.players.push(Player::new(name, owner));
+                self.players.len() == 1
+            }
+            (None, true) => false,
+        }
+    }
+
+    /// Returns the player owned by `owner`.
+    fn by_owner(&mut self, owner: &str) -> Option<&mut Player> {
+        self.players.iter_mut().find(|player| player.owner == owner)
+    }
+
+    /// Returns the player that sent a signal, and whether it is the active
+    /// one.
+    fn by_sender(&mut self, sender: Option<&str>) -> Option<(&mut Player, bool)> {
+        let index = self
+            .players
+            .iter()
+            .position(|player| sender == Some(player.owner.as_str()))?;
+        Some((&mut self.players[index], index == 0))
+    }
+
+    /// Returns the active player.
+    fn active(&self) -> Option<&Player> {
+        self.players.first()
+    }
+
+    /// Returns the identity of the active player, for publishing in
+    /// [`Bus::active`].
+    fn active_player(&self) -> Option<Arc<ActivePlayer>> {
+        self.active().map(|player| {
+            Arc::new(ActivePlayer {
+                app: Arc::from(
+                    player
+                        .name
+                        .strip_prefix(MPRIS_SERVICE_PREFIX)
+                        .unwrap_or(&player.name),
+                ),
+                owner: player.owner.clone(),
+                proxy: OnceLock::new(),
+            })
+        })
+    }
+}
+
+/// Identity of the active player, replaced as a whole whenever another
+/// player becomes active or the active one gets a new owner.
+#[derive(Debug)]
+struct ActivePlayer {
+    /// Application name, e.g. `spotify`.
+    app: Arc<str>,
+    /// Unique name of the connection owning the player's bus name.
+    owner: String,
+    /// Proxy bound to `owner`, created on first use.
+    proxy: OnceLock<zbus::Proxy<'static>>,
+}
+
+/// The session bus connection and the player registry, kept current by a
+/// signal task for as long as any backend uses them.
+#[derive(Debug)]
+struct Bus {
+    connection: zbus::Connection,
+    players: Arc<Mutex<PlayerRegistry>>,
+    /// The active player, swapped by the signal task on every change.
+    /// Readers load it without taking a lock, so they never wait for the
+    /// signal task or for each other.
+    active: Arc<ArcSwapOption<ActivePlayer>>,
+    /// Closed by the signal task when it ends; the task ends once this is
+    /// dropped. Replaced when tracking is resumed.
+    tracking: ArcSwap<watch::Receiver<()>>,
+    /// Held while tracking is resumed, so only one backend resumes it.
+    resuming: tokio::sync::Mutex<()>,
+    /// Local artwork files, read once and reused while unchanged.
+    artwork: ArtworkFiles,
+}
+
+/// The bus shared by the backends of this process, while any is alive.
+static SHARED_BUS: OnceLock<tokio::sync::Mutex<Weak<Bus>>> = OnceLock::new();
+
+impl Bus {
+    /// Returns the shared bus, connecting on `runtime` if no backend uses
+    /// it yet.
+    ///
+    /// If the signal task of the shared bus has stopped, because the
+    /// runtime it was spawned on shut down, it is resumed on `runtime`. A
+    /// bus that cannot be resumed, because its connection was lost, is
+    /// replaced by a new one.
+    async fn shared(runtime: &Handle) -> MediaResult<Arc<Self>> {
+        let mut shared = SHARED_BUS.get_or_init(Default::default).lock().await;
+        if let Some(bus) = shared.upgrade() {
+            if bus.resume(runtime).await.is_ok() {
+                return Ok(bus);
             }
         }
+        let bus = Arc::new(Self::connect(runtime).await?);
+        *shared = Arc::downgrade(&bus);
+        drop(shared);
+        Ok(bus)
     }
 
-    /// Async constructor.
-    async fn new_async() -> MediaResult<Self> {
+    /// Opens a new connection to the session bus and starts tracking
+    /// players on `runtime`.
+    async fn connect(runtime: &Handle) -> MediaResult<Self> {
         let connection = zbus::Connection::session()
             .await
             .map_err(|e| MediaError::DBusError(format!("Failed to connect to session bus: {e}")))?;
+        Self::track(connection, runtime).await
+    }
 
-        let player_name = Self::find_player(&connection).await?;
+    /// Starts tracking the players on the bus of `connection`, on
+    /// `runtime`.
+    async fn track(connection: zbus::Connection, runtime: &Handle) -> MediaResult<Self> {
+        let (signals, registry) = Self::subscribe(&connection).await?;
+        let active = Arc::new(ArcSwapOption::from(registry.active_player()));
+        let players = Arc::new(Mutex::new(registry));
+        let tracking = Self::spawn_tracking(runtime, signals, &players, &active);
 
         Ok(Self {
-            connection: Some(connection),
-            player_name: Arc::new(RwLock::new(player_name)),
+            connection,
+            players,
+            active,
+            tracking: ArcSwap::from_pointee(tracking),
+            resuming: tokio::sync::Mutex::new(()),
+            artwork: ArtworkFiles::default(),
+        })
+    }
+
+    /// Restarts the signal task on `runtime` if it has stopped, and does
+    /// nothing while it runs.
+    ///
+    /// The signal task runs on the runtime of the backend that connected.
+    /// When that runtime shuts down, for example because the C API handle
+    /// owning it was freed, the backends left resume tracking on their own
+    /// runtime: the players are listed again and the subscriptions are
+    /// renewed on the same connection.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the connection was lost.
+    async fn resume(&self, runtime: &Handle) -> MediaResult<()> {
+        if self.is_tracking() {
+            return Ok(());
+        }
+        let resuming = self.resuming.lock().await;
+        if self.is_tracking() {
+            return Ok(());
+        }
+
+        let (signals, registry) = Self::subscribe(&self.connection).await?;
+        self.active.store(registry.active_player());
+        *lock(&self.players) = registry;
+        let tracking = Self::spawn_tracking(runtime, signals, &self.players, &self.active);
+        self.tracking.store(Arc::new(tracking));
+        drop(resuming);
+        Ok(())
+    }
+
+    /// Subscribes to the player signals on `connection` and lists the
+    /// players already on the bus.
+    async fn subscribe(
+        connection: &zbus::Connection,
+    ) -> MediaResult<(
+        impl Stream<Item = zbus::Result<zbus::Message>> + Send + 'static,
+        PlayerRegistry,
+    )> {
+        // Subscribe before listing, so no player or change slips in between.
+        let owners = zbus::MatchRule::builder()
+            .msg_type(zbus::message::Type::Signal)
+            .sender(BUS_NAME)
+            .and_then(|rule| rule.interface(BUS_NAME))
+            .and_then(|rule| rule.member("NameOwnerChanged"))
+            .and_then(|rule| rule.path(BUS_PATH))
+            .and_then(|rule| rule.arg0ns(MPRIS_NAMESPACE))
+            .map(zbus::MatchRuleBuilder::build);
+        let properties = zbus::MatchRule::builder()
+            .msg_type(zbus::message::Type::Signal)
+            .interface(PROPERTIES_INTERFACE)
+            .and_then(|rule| rule.member("PropertiesChanged"))
+            .and_then(|rule| rule.path(MPRIS_PATH))
+            .and_then(|rule| rule.arg(0, MPRIS_PLAYER_INTERFACE))
+            .map(zbus::MatchRuleBuilder::build);
+        let seeks = zbus::MatchRule::builder()
+            .msg_type(zbus::message::Type::Signal)
+            .interface(MPRIS_PLAYER_INTERFACE)
+            .and_then(|rule| rule.member("Seeked"))
+            .and_then(|rule| rule.path(MPRIS_PATH))
+            .map(zbus::MatchRuleBuilder::build);
+        let signals = futures::stream::select(
+            LinuxBackend::signal_stream(connection, owners).await?,
+            futures::stream::select(
+                LinuxBackend::signal_stream(connection, properties).await?,
+                LinuxBackend::signal_stream(connection, seeks).await?,
+            ),
+        );
+
+        let registry = LinuxBackend::list_players(connection).await?;
+        Ok((signals, registry))
+    }
+
+    /// Spawns the signal task on `runtime` and returns the receiver it
+    /// closes when it ends.
+    fn spawn_tracking(
+        runtime: &Handle,
+        signals: impl Stream<Item = zbus::Result<zbus::Message>> + Send + 'static,
+        players: &Arc<Mutex<PlayerRegistry>>,
+        active: &Arc<ArcSwapOption<ActivePlayer>>,
+    ) -> watch::Receiver<()> {
+        let (tracking_tx, tracking) = watch::channel(());
+        runtime.spawn(LinuxBackend::track_players(
+            signals,
+            Arc::clone(players),
+            Arc::clone(active),
+            tracking_tx,
+        ));
+        tracking
+    }
+
+    /// Returns `true` while the signal task keeps the registry current.
+    fn is_tracking(&self) -> bool {
+        self.tracking.load().has_changed().is_ok()
+    }
+}
+
+/// Closes the subscriptions when the signal task ends or is dropped with
+/// its runtime.
+struct CloseOnDrop(Arc<Mutex<PlayerRegistry>>);
+
+impl Drop for CloseOnDrop {
+    fn drop(&mut self) {
+        lock(&self.0).subscribers.close();
+    }
+}
+
+/// Linux MPRIS backend.
+#[derive(Clone, Debug)]
+pub struct LinuxBackend {
+    bus: Arc<Bus>,
+    runtime: Handle,
+}
+
+impl LinuxBackend {
+    /// Creates a new Linux backend instance.
+    ///
+    /// All backends created this way share one session bus connection,
+    /// player registry and signal task: the first one connects, later ones
+    /// reuse it at no cost, and it is closed with the last one. Background
+    /// work runs on `runtime`, and the signal task on the runtime of the
+    /// backend that connected. If that runtime shuts down first, the next
+    /// backend call resumes tracking on the caller's `runtime`.
+    ///
+    /// Connecting does not need a Tokio runtime: zbus drives its socket on
+    /// its own executor, so the connection future is simply blocked on in
+    /// place. From async code, use [`new_async`](Self::new_async) instead.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the session bus cannot be
+    /// reached.
+    pub fn new(runtime: Handle) -> MediaResult<Self> {
+        futures::executor::block_on(Self::new_async(runtime))
+    }
+
+    /// Creates a backend with a session bus connection of its own.
+    ///
+    /// Nothing is shared with other backends, so this pays for connecting
+    /// and listing the players every time, and the signal task runs on
+    /// `runtime`. Use it to keep the backend's bus traffic apart.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the session bus cannot be
+    /// reached.
+    pub fn with_private_connection(runtime: Handle) -> MediaResult<Self> {
+        futures::executor::block_on(async {
+            let bus = Arc::new(Bus::connect(&runtime).await?);
+            Ok(Self { bus, runtime })
         })
     }
 
-    /// Finds an active MPRIS player.
-    async fn find_player(connection: &zbus::Connection) -> MediaResult<Option<String>> {
+    /// Creates a backend on an existing connection, to any bus.
+    ///
+    /// Like [`with_private_connection`](Self::with_private_connection),
+    /// nothing is shared with other backends. This is how a backend is
+    /// pointed at a bus other than the session bus, such as the private
+    /// bus of `MockSessionBus` from the `mock-mpris` feature.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the players on the bus cannot
+    /// be listed.
+    pub async fn with_connection(
+        connection: zbus::Connection,
+        runtime: Handle,
+    ) -> MediaResult<Self> {
+        let bus = Arc::new(Bus::track(connection, &runtime).await?);
+        Ok(Self { bus, runtime })
+    }
+
+    /// Creates a new Linux backend instance without blocking the calling
+    /// task.
+    ///
+    /// Same as [`new`](Self::new), but connects on the caller's executor,
+    /// so it is safe to use from async code.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the session bus cannot be
+    /// reached.
+    pub async fn new_async(runtime: Handle) -> MediaResult<Self> {
+        let bus = Bus::shared(&runtime).await?;
+        Ok(Self { bus, runtime })
+    }
+
+    /// Registers a match rule and returns the stream of matching signals.
+    ///
+    /// The rule is removed from the bus again when the stream is dropped.
+    async fn signal_stream(
+        connection: &zbus::Connection,
+        rule: zbus::Result<zbus::MatchRule<'static>>,
+    ) -> MediaResult<zbus::MessageStream> {
+        let rule = rule.map_err(|e| MediaError::DBusError(format!("Invalid match rule: {e}")))?;
+        zbus::MessageStream::for_match_rule(rule, connection, Some(SIGNAL_QUEUE))
+            .await
+            .map_err(|e| MediaError::DBusError(format!("Failed to add match rule: {e}")))
+    }
+
+    /// Lists the MPRIS players already on the bus.
+    async fn list_players(connection: &zbus::Connection) -> MediaResult<PlayerRegistry> {
         let proxy = zbus::fdo::DBusProxy::new(connection)
             .await
             .map_err(|e| MediaError::DBusError(format!("Failed to create DBus proxy: {e}")))?;
@@ -75,24 +761,200 @@ impl LinuxBackend {
             .await
             .map_err(|e| MediaError::DBusError(format!("Failed to list names: {e}")))?;
 
+        let mut registry = PlayerRegistry::default();
         for name in names {
-            if name.starts_with(MPRIS_SERVICE_PREFIX) {
-                return Ok(Some(name.to_string()));
+            if !name.starts_with(MPRIS_SERVICE_PREFIX) {
+                continue;
+            }
+            let Ok(bus_name) = zbus::names::BusName::try_from(name.as_str()) else {
+                continue;
+            };
+            // The player may have quit since the names were listed.
+            if let Ok(owner) = proxy.get_name_owner(bus_name).await {
+                registry.set_owner(name.as_str(), owner.as_str());
+            }
+        }
+
+        Ok(registry)
+    }
+
+    /// Applies player signals to the registry until every backend handle
+    /// is gone, storing the active player in `active`.
+    ///
+    /// Updates of the active player are passed on to every subscription.
+    /// Once the signals end, so do the subscriptions, and their pipelines
+    /// fall back to polling.
+    async fn track_players(
+        signals: impl Stream<Item = zbus::Result<zbus::Message>>,
+        players: Arc<Mutex<PlayerRegistry>>,
+        active: Arc<ArcSwapOption<ActivePlayer>>,
+        tracking: watch::Sender<()>,
+    ) {
+        let _close = CloseOnDrop(Arc::clone(&players));
+        let mut signals = std::pin::pin!(signals);
+        loop {
+            let message = tokio::select! {
+                () = tracking.closed() => break,
+                message = signals.next() => message,
+            };
+            let message = match message {
+                Some(Ok(message)) => message,
+                Some(Err(e)) => {
+                    lock(&players)
+                        .subscribers
+                        .push(&RawUpdate::Error(MediaError::DBusError(format!(
+                            "Failed to receive signal: {e}"
+                        ))));
+                    continue;
+                }
+                None => break,
+            };
+
+            let header = message.header();
+            let sender = header.sender().map(zbus::names::UniqueName::as_str);
+            let body = message.body();
+            let now = Instant::now();
+            let mut registry = lock(&players);
+
+            let updates = match header.member().map(zbus::names::MemberName::as_str) {
+                Some("NameOwnerChanged") => {
+                    let Ok((name, _, owner)) = body.deserialize::<(&str, &str, &str)>() else {
+                        continue;
+                    };
+                    if !registry.set_owner(name, owner) {
+                        continue;
+                    }
+                    let player = registry.active_player();
+                    let update = player.as_ref().map_or(RawUpdate::SessionClosed, |player| {
+                        RawUpdate::SessionOpened {
+                            app_name: player.app.to_string(),
+                        }
+                    });
+                    active.store(player);
+                    vec![update]
+                }
+                Some("PropertiesChanged") => {
+                    let Some((player, is_active)) = registry.by_sender(sender) else {
+                        continue;
+                    };
+                    let changes = body.deserialize::<(&str, HashMap<&str, Value<'_>>, Vec<&str>)>();
+                    let updates = if let Ok((_, changed, invalidated)) = changes {
+                        Self::apply_changes(player, &changed, &invalidated, now)
+                    } else {
+                        player.synced = false;
+                        vec![RawUpdate::Invalidated]
+                    };
+                    if !is_active {
+                        continue;
+                    }
+                    updates
+                }
+                Some("Seeked") => {
+                    let Ok(position_us) = body.deserialize::<i64>() else {
+                        continue;
+                    };
+                    let Some((player, is_active)) = registry.by_sender(sender) else {
+                        continue;
+                    };
+                    let update = Self::apply_seek(player, position_us, now);
+                    if !is_active {
+                        continue;
+                    }
+                    vec![update]
+                }
+                _ => continue,
+            };
+            for update in &updates {
+                registry.subscribers.push(update);
             }
         }
+    }
 
-        Ok(None)
+    /// Resumes tracking on this backend's runtime if the signal task has
+    /// stopped, and returns `true` if the registry is kept current.
+    async fn tracking(&self) -> bool {
+        self.bus.resume(&self.runtime).await.is_ok()
     }
 
-    /// Gets the player proxy.
-    async fn get_proxy(&self) -> MediaResult<zbus::Proxy<'_>> {
-        let connection = self.connection.as_ref().ok_or(MediaError::NoSession)?;
-        let player_guard = self.player_name.read().await;
-        let player_name = player_guard.as_ref().ok_or(MediaError::NoSession)?;
+    /// Locks the player registry.
+    fn players(&self) -> MutexGuard<'_, PlayerRegistry> {
+        lock(&self.bus.players)
+    }
+
+    /// Returns the active player's proxy, creating it on first use.
+    ///
+    /// The proxy lives as long as the player's bus name keeps its owner and
+    /// is only used for method calls; player state comes from the registry.
+    /// It therefore caches no properties and adds no match rule of its own.
+    /// Finding the cached proxy takes no lock.
+    async fn get_proxy(&self) -> MediaResult<zbus::Proxy<'static>> {
+        self.tracking().await;
+        let player = self.bus.active.load_full().ok_or(MediaError::NoSession)?;
+        if let Some(proxy) = player.proxy.get() {
+            return Ok(proxy.clone());
+        }
 
-        zbus::Proxy::new(connection, player_name, MPRIS_PATH, MPRIS_PLAYER_INTERFACE)
+        let proxy = zbus::proxy::Builder::<zbus::Proxy<'static>>::new(&self.bus.connection)
+            .destination(player.owner.clone())
+            .and_then(|builder| builder.path(MPRIS_PATH))
+            .and_then(|builder| builder.interface(MPRIS_PLAYER_INTERFACE))
+            .map_err(|e| MediaError::DBusError(format!("Failed to create proxy: {e}")))?
+            .cache_properties(zbus::proxy::CacheProperties::No)
+            .build()
             .await
-            .map_err(|e| MediaError::DBusError(format!("Failed to create proxy: {e}")))
+            .map_err(|e| MediaError::DBusError(format!("Failed to create proxy: {e}")))?;
+
+        // If the owner changed while the proxy was built, `player` is no
+        // longer published and the proxy is dropped with it.
+        Ok(player.proxy.get_or_init(|| proxy).clone())
+    }
+
+    /// Returns the active player's state as known locally, or `None` if
+    /// there is no player or the registry is no longer kept current.
+    fn known_state(&self) -> Option<PlayerState> {
+        if !self.bus.is_tracking() {
+            return None;
+        }
+        self.players().active().map(|player| player.state)
+    }
+
+    /// Fails without a D-Bus call if the active player does not accept a
+    /// command. Without local state the player decides.
+    fn require(&self, supported: impl FnOnce(&Capabilities) -> bool) -> MediaResult<()> {
+        self.known_state()
+            .map_or(Ok(()), |state| state.require(supported))
+    }
+
+    /// Checks a property write against the active player's capabilities
+    /// and its cached value.
+    ///
+    /// Returns `false` if the property already has the value, so the write
+    /// can be skipped.
+    fn needs_write(&self, cached: impl FnOnce(&PlayerState) -> bool) -> MediaResult<bool> {
+        match self.known_state() {
+            Some(state) => {
+                state.require(|can| can.can_control)?;
+                Ok(!cached(&state))
+            }
+            None => Ok(true),
+        }
+    }
+
+    /// Returns how to move the active player to `position` in one call,
+    /// if enough is known about it.
+    fn seek_target(&self, position: Duration) -> Option<SeekTarget> {
+        self.players()
+            .active()?
+            .seek_target(position, Instant::now())
+    }
+
+    /// Returns the active player's local artwork file and the
+    /// `mpris:trackid` of the track it is the cover of.
+    fn artwork_file(&self) -> Option<(PathBuf, Option<Arc<str>>)> {
+        self.players().active().and_then(|player| {
+            let path = file_url_path(player.track.thumbnail_url.as_deref()?)?;
+            Some((path, player.track_id.clone()))
+        })
     }
 
     /// Converts MPRIS playback state.
@@ -105,179 +967,425 @@ impl LinuxBackend {
         }
     }
 
-    /// Polls for media session changes and emits events.
-    async fn poll_events(
-        &self,
-        tx: mpsc::Sender<MediaResult<MediaSessionEvent>>,
-        debounce_duration: Duration,
-    ) {
-        let mut last_status: Option<PlaybackStatus> = None;
-        let mut last_title: Option<String> = None;
-        let mut last_emit_time = tokio::time::Instant::now();
+    /// Converts an MPRIS loop status.
+    fn convert_loop_status(status: &str) -> RepeatMode {
+        match status {
+            "Track" => RepeatMode::One,
+            "Playlist" => RepeatMode::All,
+            _ => RepeatMode::None,
+        }
+    }
 
-        loop {
-            tokio::time::sleep(Duration::from_millis(500)).await;
+    /// Reads every player property in a single `GetAll` round trip.
+    ///
+    /// Returns `None` if there is no player.
+    async fn get_all(&self) -> MediaResult<Option<MediaInfo>> {
+        let Some(player) = self.bus.active.load_full() else {
+            return Ok(None);
+        };
+        let owner = &player.owner;
 
-            if tx.is_closed() {
-                break;
-            }
+        let reply = self
+            .bus
+            .connection
+            .call_method(
+                Some(owner.as_str()),
+                MPRIS_PATH,
+                Some(PROPERTIES_INTERFACE),
+                "GetAll",
+                &(MPRIS_PLAYER_INTERFACE,),
+            )
+            .await
+            .map_err(|e| MediaError::DBusError(format!("Failed to get properties: {e}")))?;
+        let body = reply.body();
+        let properties: HashMap<&str, Value<'_>> = body
+            .deserialize()
+            .map_err(|e| MediaError::DBusError(format!("Invalid properties: {e}")))?;
 
-            // Check for player changes
-            if let Ok(conn) = self.connection.as_ref().ok_or(MediaError::NoSession) {
-                let player = Self::find_player(conn).await.unwrap_or(None);
-                let mut current_player = self.player_name.write().await;
-                if player != *current_player {
-                    *current_player = player.clone();
-                    if player.is_none() && last_status.is_some() {
-                        let _ = tx.send(Ok(MediaSessionEvent::SessionClosed)).await;
-                        last_status = None;
-                        last_title = None;
-                    }
+        // The player may have gone away during the call.
+        Ok(self
+            .players()
+            .by_owner(owner)
+            .map(|player| Self::decode_properties(&properties, player, Instant::now())))
+    }
+
+    /// Decodes the result of `GetAll` on the player interface into
+    /// `player` and returns its session.
+    fn decode_properties(
+        properties: &HashMap<&str, Value<'_>>,
+        player: &mut Player,
+        now: Instant,
+    ) -> MediaInfo {
+        let mut playback_status = PlaybackStatus::default();
+        let mut position = None;
+        let mut state = PlayerState::default();
+
+        for (name, value) in properties {
+            match (*name, variant(value)) {
+                ("PlaybackStatus", Value::Str(status)) => {
+                    playback_status = Self::convert_playback_state(status.as_str());
                 }
+                ("Position", position_us) => position = micros(position_us),
+                ("Volume", Value::F64(volume)) => state.volume = Some(*volume),
+                ("LoopStatus", Value::Str(status)) => {
+                    state.repeat = Some(Self::convert_loop_status(status.as_str()));
+                }
+                ("Shuffle", Value::Bool(enabled)) => state.shuffle = Some(*enabled),
+                ("Rate", Value::F64(rate)) => state.rate = Some(*rate),
+                (name, Value::Bool(can)) => set_capability(&mut state.capabilities, name, *can),
+                _ => {}
             }
+        }
+
+        // A player without a track may leave `Metadata` out.
+        player.update_metadata(properties.get("Metadata"));
+        player.state = state;
+        player.status = playback_status;
+        player.position = None;
+        if let Some(position) = position {
+            player.set_position(position, now);
+        }
+        player.synced = true;
+
+        MediaInfo {
+            position,
+            playback_status,
+            ..player.track.clone()
+        }
+    }
 
-            let info = match self.get_current().await {
-                Ok(Some(i)) => i,
-                Ok(None) => {
-                    if last_status.is_some() {
-                        last_status = None;
-                        let _ = tx.send(Ok(MediaSessionEvent::SessionClosed)).await;
+    /// Applies one `PropertiesChanged` signal to `player` and returns the
+    /// updates it carries.
+    ///
+    /// Metadata matching the last seen track is not passed on. Properties
+    /// that only come with their name are re-read in full.
+    fn apply_changes(
+        player: &mut Player,
+        changed: &HashMap<&str, Value<'_>>,
+        invalidated: &[&str],
+        now: Instant,
+    ) -> Vec<RawUpdate> {
+        let mut updates = Vec::with_capacity(changed.len());
+        for (name, value) in changed {
+            let update = match (*name, variant(value)) {
+                ("PlaybackStatus", Value::Str(status)) => {
+                    let status = Self::convert_playback_state(status.as_str());
+                    player.change_speed(now, |player| player.status = status);
+                    RawUpdate::PlaybackStatus(status)
+                }
+                ("Metadata", metadata) => {
+                    if !player.update_metadata(Some(metadata)) {
+                        continue;
+                    }
+                    // Players do not tell where the new track starts.
+                    player.synced = false;
+                    RawUpdate::Metadata(player.track.clone())
+                }
+                ("Volume", Value::F64(volume)) => {
+                    player.state.volume = Some(*volume);
+                    RawUpdate::Volume(*volume)
+                }
+                ("LoopStatus", Value::Str(status)) => {
+                    let mode = Self::convert_loop_status(status.as_str());
+                    player.state.repeat = Some(mode);
+                    RawUpdate::RepeatMode(mode)
+                }
+                ("Shuffle", Value::Bool(enabled)) => {
+                    player.state.shuffle = Some(*enabled);
+                    RawUpdate::Shuffle(*enabled)
+                }
+                // Rate, Position and the Can* flags have no events of their
+                // own.
+                ("Rate", Value::F64(rate)) => {
+                    player.change_speed(now, |player| player.state.rate = Some(*rate));
+                    continue;
+                }
+                ("Position", position_us) => {
+                    if let Some(position) = micros(position_us) {
+                        player.set_position(position, now);
                     }
                     continue;
                 }
-                Err(e) => {
-                    let _ = tx.send(Err(e)).await;
+                (name, Value::Bool(can)) => {
+                    set_capability(&mut player.state.capabilities, name, *can);
                     continue;
                 }
+                _ => continue,
             };
+            updates.push(update);
+        }
 
-            // Debounce check
-            let now = tokio::time::Instant::now();
-            if now.duration_since(last_emit_time) < debounce_duration {
-                continue;
-            }
+        if !invalidated.is_empty() {
+            player.synced = false;
+            updates.push(RawUpdate::Invalidated);
+        }
+        updates
+    }
 
-            // Check for metadata changes
-            let title_changed = info.title != last_title;
-            if title_changed {
-                last_title = info.title.clone();
-                let _ = tx
-                    .send(Ok(MediaSessionEvent::MetadataChanged(info.clone())))
-                    .await;
-                last_emit_time = now;
-                continue;
+    /// Applies a `Seeked` signal to `player` and returns its update.
+    fn apply_seek(player: &mut Player, position_us: i64, now: Instant) -> RawUpdate {
+        let old_position = player.position_at(now);
+        let position = Duration::from_micros(u64::try_from(position_us).unwrap_or_default());
+        player.set_position(position, now);
+        RawUpdate::Seeked {
+            position,
+            old_position,
+        }
+    }
+}
+
+/// Replaces `field` with `value` unless they are equal, allocating only
+/// when they differ. Returns `true` if `field` changed.
+fn assign_str(field: &mut Option<Arc<str>>, value: Option<&str>) -> bool {
+    if field.as_deref() == value {
+        return false;
+    }
+    *field = value.map(Arc::from);
+    true
+}
+
+/// Replaces `field` with the comma-separated strings of an `s` or `as`
+/// value, allocating only when they differ. Returns `true` if `field`
+/// changed.
+fn assign_list<'v>(field: &mut Option<Arc<str>>, value: Option<&'v Value<'v>>) -> bool {
+    let parts = || value.into_iter().flat_map(strings);
+    let unchanged = field.as_deref().map_or_else(
+        || parts().next().is_none(),
+        |joined| parts().next().is_some() && is_joined(joined, parts()),
+    );
+    if unchanged {
+        return false;
+    }
+
+    *field = parts().next().is_some().then(|| {
+        let mut joined = String::new();
+        for part in parts() {
+            if !joined.is_empty() {
+                joined.push_str(", ");
             }
+            joined.push_str(part);
+        }
+        Arc::from(joined)
+    });
+    true
+}
+
+/// Tells whether `joined` is `parts` separated by commas.
+fn is_joined<'s>(joined: &str, parts: impl Iterator<Item = &'s str>) -> bool {
+    let mut rest = Some(joined);
+    for (index, part) in parts.enumerate() {
+        rest = rest
+            .and_then(|rest| {
+                if index == 0 {
+                    Some(rest)
+                } else {
+                    rest.strip_prefix(", ")
+                }
+            })
+            .and_then(|rest| rest.strip_prefix(part));
+    }
+    rest == Some("")
+}
+
+/// Replaces `field` with `value`. Returns `true` if it changed.
+fn assign<T: PartialEq>(field: &mut Option<T>, value: Option<T>) -> bool {
+    if *field == value {
+        return false;
+    }
+    *field = value;
+    true
+}
+
+/// Borrows the string of an `s` or `o` value.
+fn string<'v>(value: &'v Value<'_>) -> Option<&'v str> {
+    match value {
+        Value::Str(s) => Some(s.as_str()),
+        Value::ObjectPath(path) => Some(path.as_str()),
+        _ => None,
+    }
+}
 
-            // Check for playback status changes
-            if Some(info.playback_status) != last_status {
-                last_status = Some(info.playback_status);
-                let _ = tx
-                    .send(Ok(MediaSessionEvent::PlaybackStatusChanged(
-                        info.playback_status,
-                    )))
-                    .await;
-                last_emit_time = now;
+/// Iterates the strings of an `s` or `as` value; players differ in which
+/// one they send for lists.
+fn strings<'v>(value: &'v Value<'v>) -> impl Iterator<Item = &'v str> {
+    let (single, list) = match value {
+        Value::Str(s) => (Some(s.as_str()), None),
+        Value::Array(array) => (None, Some(array.iter())),
+        _ => (None, None),
+    };
+    single
+        .into_iter()
+        .chain(list.into_iter().flatten().filter_map(string))
+}
+
+/// Reads an integer of any width; players differ in which one they send.
+fn integer(value: &Value<'_>) -> Option<i64> {
+    match *value {
+        Value::I16(n) => Some(n.into()),
+        Value::I32(n) => Some(n.into()),
+        Value::I64(n) => Some(n),
+        Value::U8(n) => Some(n.into()),
+        Value::U16(n) => Some(n.into()),
+        Value::U32(n) => Some(n.into()),
+        Value::U64(n) => i64::try_from(n).ok(),
+        _ => None,
+    }
+}
+
+/// Fingerprints a value without copying any of it.
+fn fingerprint(value: &Value<'_>) -> u64 {
+    let mut hasher = DefaultHasher::new();
+    hash_value(value, &mut hasher);
+    hasher.finish()
+}
+
+/// Feeds a value, with its type, into `state`.
+fn hash_value(value: &Value<'_>, state: &mut DefaultHasher) {
+    std::mem::discriminant(value).hash(state);
+    match value {
+        Value::U8(n) => n.hash(state),
+        Value::Bool(b) => b.hash(state),
+        Value::I16(n) => n.hash(state),
+        Value::U16(n) => n.hash(state),
+        Value::I32(n) => n.hash(state),
+        Value::U32(n) => n.hash(state),
+        Value::I64(n) => n.hash(state),
+        Value::U64(n) => n.hash(state),
+        Value::F64(n) => n.to_bits().hash(state),
+        Value::Str(s) => s.as_str().hash(state),
+        Value::Signature(signature) => signature.as_str().hash(state),
+        Value::ObjectPath(path) => path.as_str().hash(state),
+        Value::Value(inner) => hash_value(inner, state),
+        Value::Array(array) => {
+            for element in array.iter() {
+                hash_value(element, state);
+            }
+        }
+        // Entries are combined independently of their order, which players
+        // that build the dictionary from a hash table do not keep stable.
+        Value::Dict(dict) => {
+            let mut entries = 0_u64;
+            for (key, value) in dict.iter() {
+                let mut entry = DefaultHasher::new();
+                hash_value(key, &mut entry);
+                hash_value(value, &mut entry);
+                entries = entries.wrapping_add(entry.finish());
+            }
+            entries.hash(state);
+        }
+        Value::Structure(structure) => {
+            for field in structure.fields() {
+                hash_value(field, state);
             }
         }
+        // File descriptors never appear in MPRIS metadata.
+        Value::Fd(_) => {}
     }
 }
 
-#[async_trait::async_trait]
+/// Converts a duration to MPRIS microseconds.
+fn to_micros(duration: Duration) -> i64 {
+    i64::try_from(duration.as_micros()).unwrap_or(i64::MAX)
+}
+
+/// Reads a non-negative duration in microseconds.
+fn micros(value: &Value<'_>) -> Option<Duration> {
+    integer(value)
+        .and_then(|n| u64::try_from(n).ok())
+        .map(Duration::from_micros)
+}
+
+/// Unwraps a value that arrived as a variant, as `a{sv}` entries do.
+fn variant<'v, 'a>(value: &'v Value<'a>) -> &'v Value<'a> {
+    match value {
+        Value::Value(inner) => inner,
+        value => value,
+    }
+}
+
+/// Locks the player registry, ignoring poisoning: every update leaves it
+/// consistent.
+fn lock(players: &Mutex<PlayerRegistry>) -> MutexGuard<'_, PlayerRegistry> {
+    players.lock().unwrap_or_else(PoisonError::into_inner)
+}
+
 impl MediaSessionBackend for LinuxBackend {
     fn platform_name(&self) -> &'static str {
         "linux"
     }
 
     async fn get_current(&self) -> MediaResult<Option<MediaInfo>> {
-        let proxy = match self.get_proxy().await {
-            Ok(p) => p,
-            Err(MediaError::NoSession) => return Ok(None),
-            Err(e) => return Err(e),
-        };
+        let tracking = self.tracking().await;
+        let known = self
+            .players()
+            .active()
+            .map(|player| player.session(Instant::now()).filter(|_| tracking));
+        match known {
+            None => Ok(None),
+            Some(Some(info)) => Ok(Some(info)),
+            // Not read since the player appeared or changed track, or no
+            // longer kept current.
+            Some(None) => self.get_all().await,
+        }
+    }
 
-        let metadata: zbus::zvariant::Value<'_> = proxy
-            .get_property("Metadata")
-            .await
-            .map_err(|e| MediaError::DBusError(format!("Failed to get metadata: {e}")))?;
+    async fn get_artwork(&self) -> MediaResult<Option<Arc<[u8]>>> {
+        // Only local files are loaded; remote artwork is left to the caller
+        // through `thumbnail_url`.
+        let Some((path, track)) = self.artwork_file() else {
+            return Ok(None);
+        };
 
-        let status: String = proxy
-            .get_property("PlaybackStatus")
+        let bus = Arc::clone(&self.bus);
+        let artwork = self
+            .runtime
+            .spawn_blocking(move || bus.artwork.load(&path, track.as_deref()))
             .await
-            .map_err(|e| MediaError::DBusError(format!("Failed to get status: {e}")))?;
+            .map_err(|e| MediaError::Backend {
+                platform: "linux".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })?;
 
-        let position: i64 = proxy
-            .get_property("Position")
-            .await
-            .map_err(|e| MediaError::DBusError(format!("Failed to get position: {e}")))?;
+        // A cover that is gone or unreadable is simply missing.
+        Ok(artwork.ok().flatten())
+    }
 
-        let mut info = MediaInfo {
-            playback_status: Self::convert_playback_state(&status),
-            position: Some(Duration::from_micros(position as u64)),
-            ..Default::default()
+    async fn artwork_key(&self) -> MediaResult<Option<u64>> {
+        // Without a local file there is no artwork to tell apart.
+        let Some((path, track)) = self.artwork_file() else {
+            return Ok(Some(0));
         };
 
-        if let zbus::zvariant::Value::Dict(dict) = metadata {
-            for (key, value) in dict.iter() {
-                let key_str = match key.as_str() {
-                    Some(s) => s,
-                    None => continue,
-                };
-
-                match key_str {
-                    "xesam:title" => {
-                        if let zbus::zvariant::Value::Str(s) = value {
-                            info.title = Some(s.to_string());
-                        }
-                    }
-                    "xesam:artist" => {
-                        if let zbus::zvariant::Value::Array(arr) = value {
-                            let artists: Vec<String> = arr
-                                .iter()
-                                .filter_map(|v| {
-                                    if let zbus::zvariant::Value::Str(s) = v {
-                                        Some(s.to_string())
-                                    } else {
-                                        None
-                                    }
-                                })
-                                .collect();
-                            info.artist = Some(artists.join(", "));
-                        }
-                    }
-                    "xesam:album" => {
-                        if let zbus::zvariant::Value::Str(s) = value {
-                            info.album = Some(s.to_string());
-                        }
-                    }
-                    "mpris:length" => {
-                        if let zbus::zvariant::Value::I64(n) = value {
-                            info.duration = Some(Duration::from_micros(n as u64));
-                        }
-                    }
-                    _ => {}
-                }
-            }
-        }
-
-        Ok(Some(info))
+        let key = self
+            .runtime
+            .spawn_blocking(move || file_key(&path, track.as_deref()))
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "linux".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })?;
+        // A file that cannot be read is looked at again by `get_artwork`.
+        Ok(key.ok())
     }
 
-    async fn get_artwork(&self) -> MediaResult<Option<Vec<u8>>> {
-        // Artwork would require fetching the artwork URL and downloading it
-        // This is a simplified implementation
-        Ok(None)
+    fn capabilities(&self) -> MediaResult<Option<Capabilities>> {
+        Ok(self
+            .players()
+            .active()
+            .map(|player| player.state.capabilities))
     }
 
-    fn get_active_app(&self) -> MediaResult<Option<String>> {
-        let player_guard = futures::executor::block_on(self.player_name.read());
-        Ok(player_guard.as_ref().map(|name| {
-            name.strip_prefix(MPRIS_SERVICE_PREFIX)
-                .unwrap_or(name)
-                .to_string()
-        }))
+    fn get_active_app(&self) -> MediaResult<Option<Arc<str>>> {
+        Ok(self
+            .bus
+            .active
+            .load()
+            .as_ref()
+            .map(|player| Arc::clone(&player.app)))
     }
 
     async fn play(&self) -> MediaResult<()> {
+        self.require(|can| can.can_play)?;
         let proxy = self.get_proxy().await?;
         proxy
             .call("Play", &())
@@ -286,6 +1394,7 @@ impl MediaSessionBackend for LinuxBackend {
     }
 
     async fn pause(&self) -> MediaResult<()> {
+        self.require(|can| can.can_pause)?;
         let proxy = self.get_proxy().await?;
         proxy
             .call("Pause", &())
@@ -294,6 +1403,7 @@ impl MediaSessionBackend for LinuxBackend {
     }
 
     async fn play_pause(&self) -> MediaResult<()> {
+        self.require(|can| can.can_pause)?;
         let proxy = self.get_proxy().await?;
         proxy
             .call("PlayPause", &())
@@ -302,6 +1412,7 @@ impl MediaSessionBackend for LinuxBackend {
     }
 
     async fn stop(&self) -> MediaResult<()> {
+        self.require(|can| can.can_control)?;
         let proxy = self.get_proxy().await?;
         proxy
             .call("Stop", &())
@@ -310,6 +1421,7 @@ impl MediaSessionBackend for LinuxBackend {
     }
 
     async fn next(&self) -> MediaResult<()> {
+        self.require(|can| can.can_go_next)?;
         let proxy = self.get_proxy().await?;
         proxy
             .call("Next", &())
@@ -318,6 +1430,7 @@ impl MediaSessionBackend for LinuxBackend {
     }
 
     async fn previous(&self) -> MediaResult<()> {
+        self.require(|can| can.can_go_previous)?;
         let proxy = self.get_proxy().await?;
         proxy
             .call("Previous", &())
@@ -326,22 +1439,45 @@ impl MediaSessionBackend for LinuxBackend {
     }
 
     async fn seek(&self, position: Duration) -> MediaResult<()> {
+        self.require(|can| can.can_seek)?;
         let proxy = self.get_proxy().await?;
-        let position_us = position.as_micros() as i64;
+        let target = if let Some(target) = self.seek_target(position) {
+            target
+        } else {
+            // Neither the track nor the position is known yet.
+            self.get_all().await?;
+            self.seek_target(position).ok_or(MediaError::NoSession)?
+        };
+
+        match target {
+            SeekTarget::Track(track_id) => {
+                let track_id = zbus::zvariant::ObjectPath::try_from(track_id.as_str())
+                    .map_err(|e| MediaError::DBusError(format!("Invalid track id: {e}")))?;
+                proxy
+                    .call("SetPosition", &(track_id, to_micros(position)))
+                    .await
+                    .map_err(|e| MediaError::DBusError(format!("Failed to call SetPosition: {e}")))
+            }
+            SeekTarget::Offset(offset_us) => proxy
+                .call("Seek", &(offset_us,))
+                .await
+                .map_err(|e| MediaError::DBusError(format!("Failed to call Seek: {e}"))),
+        }
+    }
 
+    async fn seek_by(&self, offset_ms: i64) -> MediaResult<()> {
+        self.require(|can| can.can_seek)?;
+        let proxy = self.get_proxy().await?;
         proxy
-            .call(
-                "SetPosition",
-                &(
-                    zbus::zvariant::ObjectPath::from_static_str_unchecked(MPRIS_PATH),
-                    position_us,
-                ),
-            )
+            .call("Seek", &(offset_ms.saturating_mul(1000),))
             .await
-            .map_err(|e| MediaError::DBusError(format!("Failed to call SetPosition: {e}")))
+            .map_err(|e| MediaError::DBusError(format!("Failed to call Seek: {e}")))
     }
 
     async fn set_volume(&self, volume: f64) -> MediaResult<()> {
+        if !self.needs_write(|state| state.volume == Some(volume))? {
+            return Ok(());
+        }
         let proxy = self.get_proxy().await?;
         proxy
             .set_property("Volume", &volume)
@@ -350,6 +1486,9 @@ impl MediaSessionBackend for LinuxBackend {
     }
 
     async fn set_repeat_mode(&self, mode: RepeatMode) -> MediaResult<()> {
+        if !self.needs_write(|state| state.repeat == Some(mode))? {
+            return Ok(());
+        }
         let proxy = self.get_proxy().await?;
         let loop_status = match mode {
             RepeatMode::None => "None",
@@ -363,6 +1502,9 @@ impl MediaSessionBackend for LinuxBackend {
     }
 
     async fn set_shuffle(&self, enabled: bool) -> MediaResult<()> {
+        if !self.needs_write(|state| state.shuffle == Some(enabled))? {
+            return Ok(());
+        }
         let proxy = self.get_proxy().await?;
         proxy
             .set_property("Shuffle", &enabled)
@@ -370,15 +1512,12 @@ impl MediaSessionBackend for LinuxBackend {
             .map_err(|e| MediaError::DBusError(format!("Failed to set shuffle: {e}")))
     }
 
-    async fn start_listening(
-        &self,
-        tx: mpsc::Sender<MediaResult<MediaSessionEvent>>,
-        debounce_duration: Duration,
-    ) -> MediaResult<()> {
-        let this = self.clone();
-        tokio::spawn(async move {
-            this.poll_events(tx, debounce_duration).await;
-        });
+    async fn subscribe(&self, sink: EventSink) -> MediaResult<()> {
+        // The signals are already being received; the subscription only
+        // has to be fed from them. If tracking cannot be resumed, the
+        // subscription is closed at once and its pipeline polls.
+        self.tracking().await;
+        self.players().subscribers.add(sink);
         Ok(())
     }
 }
@@ -404,9 +1543,340 @@ mod tests {
     }
 
     #[test]
-    #[ignore]
-    fn test_backend_creation() {
-        let result = LinuxBackend::new();
-        println!("Linux backend result: {result:?}");
+    fn test_loop_status_conversion() {
+        assert_eq!(LinuxBackend::convert_loop_status("Track"), RepeatMode::One);
+        assert_eq!(
+            LinuxBackend::convert_loop_status("Playlist"),
+            RepeatMode::All
+        );
+        assert_eq!(LinuxBackend::convert_loop_status("None"), RepeatMode::None);
+    }
+
+    #[test]
+    fn test_player_registry() {
+        let mut registry = PlayerRegistry::default();
+        assert!(registry.active_player().is_none());
+
+        assert!(registry.set_owner("org.mpris.MediaPlayer2.spotify", ":1.10"));
+        assert!(!registry.set_owner("org.mpris.MediaPlayer2.mpv", ":1.11"));
+        assert!(!registry.set_owner("org.example.Other", ":1.12"));
+        let player = registry.active_player().unwrap();
+        assert_eq!((&*player.app, player.owner.as_str()), ("spotify", ":1.10"));
+
+        // A restarted player keeps its place under the new owner.
+        assert!(registry.set_owner("org.mpris.MediaPlayer2.spotify", ":1.20"));
+        let active = registry.active().unwrap();
+        assert_eq!(active.name, "org.mpris.MediaPlayer2.spotify");
+        assert_eq!(active.owner, ":1.20");
+        assert_eq!(registry.active_player().unwrap().owner, ":1.20");
+
+        assert!(!registry.set_owner("org.mpris.MediaPlayer2.mpv", ""));
+        assert!(registry.set_owner("org.mpris.MediaPlayer2.spotify", ""));
+        assert!(registry.active_player().is_none());
+    }
+
+    #[test]
+    fn test_metadata_decoding() {
+        let mut metadata = HashMap::new();
+        metadata.insert(
+            "mpris:trackid",
+            Value::from(zbus::zvariant::ObjectPath::try_from("/org/mpd/Tracks/7").unwrap()),
+        );
+        metadata.insert("xesam:title", Value::from("Song"));
+        metadata.insert("xesam:artist", Value::from(vec!["A"]));
+        metadata.insert("xesam:genre", Value::from("Jazz"));
+        metadata.insert("xesam:trackNumber", Value::from(3_i32));
+        metadata.insert("xesam:discNumber", Value::from(1_i32));
+        metadata.insert("xesam:contentCreated", Value::from("1959-08-17"));
+        metadata.insert("xesam:url", Value::from("file:///music/song.flac"));
+        metadata.insert("mpris:artUrl", Value::from("file:///music/cover.jpg"));
+        metadata.insert("mpris:length", Value::from(60_000_000_u64));
+        let metadata = Value::from(metadata);
+
+        let mut player = Player::new("org.mpris.MediaPlayer2.test", ":1.1");
+        assert!(player.update_track(&Metadata::decode(&metadata)));
+        let track = &player.track;
+        assert_eq!(player.track_id.as_deref(), Some("/org/mpd/Tracks/7"));
+        assert_eq!(track.artist.as_deref(), Some("A"));
+        assert_eq!(track.genre.as_deref(), Some("Jazz"));
+        assert_eq!(track.track_number, Some(3));
+        assert_eq!(track.disc_number, Some(1));
+        assert_eq!(track.year, Some(1959));
+        assert_eq!(track.url.as_deref(), Some("file:///music/song.flac"));
+        assert_eq!(
+            track.thumbnail_url.as_deref(),
+            Some("file:///music/cover.jpg")
+        );
+        assert_eq!(track.duration, Some(Duration::from_secs(60)));
+
+        // Unchanged fields keep their allocation.
+        let title = player.track.title.as_ref().unwrap().as_ptr();
+        assert!(!player.update_track(&Metadata::decode(&metadata)));
+        assert_eq!(player.track.title.as_ref().unwrap().as_ptr(), title);
+
+        assert!(player.update_track(&Metadata::default()));
+        assert_eq!(player.track, MediaInfo::default());
+        assert!(player.track_id.is_none());
+    }
+
+    #[test]
+    fn test_unchanged_metadata_is_skipped() {
+        let payload = |title: &'static str| {
+            let mut metadata = HashMap::new();
+            metadata.insert("xesam:title", Value::from(title));
+            metadata.insert("xesam:artist", Value::from(vec!["A"]));
+            Value::from(metadata)
+        };
+
+        let mut player = Player::new("org.mpris.MediaPlayer2.test", ":1.1");
+        assert!(player.update_metadata(Some(&payload("One"))));
+        let fingerprint = player.metadata_fingerprint;
+        assert!(!player.update_metadata(Some(&payload("One"))));
+        assert_eq!(player.metadata_fingerprint, fingerprint);
+
+        assert!(player.update_metadata(Some(&payload("Two"))));
+        assert_ne!(player.metadata_fingerprint, fingerprint);
+        assert_eq!(player.track.title.as_deref(), Some("Two"));
+
+        assert!(player.update_metadata(None));
+        assert!(player.track.title.is_none());
+    }
+
+    #[test]
+    fn test_joined_lists() {
+        assert!(is_joined("A, B", ["A", "B"].into_iter()));
+        assert!(!is_joined("A, B", std::iter::once("A")));
+        assert!(!is_joined("A", ["A", "B"].into_iter()));
+        assert!(!is_joined("AB", ["A", "B"].into_iter()));
+    }
+
+    #[test]
+    fn test_get_all_decoding() {
+        let mut metadata = HashMap::new();
+        metadata.insert("xesam:title", Value::from("Song"));
+
+        let mut properties = HashMap::new();
+        properties.insert("Metadata", Value::from(metadata));
+        properties.insert("PlaybackStatus", Value::from("Playing"));
+        properties.insert("Position", Value::from(5_000_000_i64));
+        properties.insert("Volume", Value::from(0.25));
+        properties.insert("LoopStatus", Value::from("Playlist"));
+        properties.insert("Rate", Value::from(1.0));
+        properties.insert("CanSeek", Value::from(false));
+
+        let mut player = Player::new("org.mpris.MediaPlayer2.test", ":1.1");
+        let info = LinuxBackend::decode_properties(&properties, &mut player, Instant::now());
+        let state = player.state;
+        assert_eq!(info.title.as_deref(), Some("Song"));
+        assert_eq!(info.playback_status, PlaybackStatus::Playing);
+        assert_eq!(info.position, Some(Duration::from_secs(5)));
+        assert_eq!(state.volume, Some(0.25));
+        assert_eq!(state.repeat, Some(RepeatMode::All));
+        assert_eq!(state.shuffle, None);
+        assert_eq!(state.rate, Some(1.0));
+        assert!(!state.capabilities.can_seek);
+        assert!(state.capabilities.can_go_next);
+    }
+
+    #[test]
+    fn test_unsupported_commands_fail_locally() {
+        let mut player = Player::new("org.mpris.MediaPlayer2.test", ":1.1");
+        let mut changed = HashMap::new();
+        changed.insert("CanGoNext", Value::from(false));
+        changed.insert("CanControl", Value::from(false));
+        assert!(LinuxBackend::apply_changes(&mut player, &changed, &[], Instant::now()).is_empty());
+
+        let state = player.state;
+        assert!(matches!(
+            state.require(|can| can.can_go_next),
+            Err(MediaError::NotSupported(_))
+        ));
+        assert!(state.require(|can| can.can_control).is_err());
+        assert!(state.require(|can| can.can_go_previous).is_ok());
+    }
+
+    #[test]
+    fn test_properties_changed_decoding() {
+        let mut metadata = HashMap::new();
+        metadata.insert("xesam:title", Value::from("Song"));
+        metadata.insert("xesam:artist", Value::from(vec!["A", "B"]));
+        metadata.insert("mpris:length", Value::from(180_000_000_i64));
+
+        let mut changed = HashMap::new();
+        changed.insert("PlaybackStatus", Value::from("Paused"));
+        changed.insert("Metadata", Value::from(metadata));
+        changed.insert("Shuffle", Value::from(true));
+        changed.insert("CanSeek", Value::from(false));
+
+        let now = Instant::now();
+        let mut player = Player::new("org.mpris.MediaPlayer2.test", ":1.1");
+        let mut received = LinuxBackend::apply_changes(&mut player, &changed, &[], now);
+        assert!(!player.state.capabilities.can_seek);
+        // The same track again is not passed on.
+        changed.remove("PlaybackStatus");
+        changed.remove("Shuffle");
+        received.extend(LinuxBackend::apply_changes(&mut player, &changed, &[], now));
+        received.extend(LinuxBackend::apply_changes(
+            &mut player,
+            &HashMap::new(),
+            &["Metadata"],
+            now,
+        ));
+
+        assert_eq!(received.len(), 4);
+        assert!(
+            received
+                .iter()
+                .any(|update| matches!(update, RawUpdate::PlaybackStatus(PlaybackStatus::Paused)))
+        );
+        assert!(
+            received
+                .iter()
+                .any(|update| matches!(update, RawUpdate::Shuffle(true)))
+        );
+        assert!(matches!(received.last(), Some(RawUpdate::Invalidated)));
+
+        let track = received
+            .iter()
+            .find_map(|update| match update {
+                RawUpdate::Metadata(track) => Some(track),
+                _ => None,
+            })
+            .unwrap();
+        assert_eq!(track.title.as_deref(), Some("Song"));
+        assert_eq!(track.artist.as_deref(), Some("A, B"));
+        assert_eq!(track.duration, Some(Duration::from_secs(180)));
+    }
+
+    #[test]
+    fn test_seek_target() {
+        let now = Instant::now();
+        let mut properties = HashMap::new();
+        properties.insert("PlaybackStatus", Value::from("Paused"));
+        properties.insert("Position", Value::from(5_000_000_i64));
+
+        let mut player = Player::new("org.mpris.MediaPlayer2.test", ":1.1");
+        assert_eq!(player.seek_target(Duration::from_secs(1), now), None);
+
+        // Without a track id, seek relative to the known position.
+        LinuxBackend::decode_properties(&properties, &mut player, now);
+        assert_eq!(
+            player.seek_target(Duration::from_secs(1), now),
+            Some(SeekTarget::Offset(-4_000_000))
+        );
+
+        let mut metadata = HashMap::new();
+        metadata.insert(
+            "mpris:trackid",
+            Value::from(zbus::zvariant::ObjectPath::try_from("/org/mpd/Tracks/7").unwrap()),
+        );
+        player.update_metadata(Some(&Value::from(metadata)));
+        assert_eq!(
+            player.seek_target(Duration::from_secs(1), now),
+            Some(SeekTarget::Track("/org/mpd/Tracks/7".to_string()))
+        );
+    }
+
+    #[test]
+    fn test_position_model() {
+        let mut properties = HashMap::new();
+        properties.insert("PlaybackStatus", Value::from("Playing"));
+        properties.insert("Position", Value::from(10_000_000_i64));
+        properties.insert("Rate", Value::from(2.0));
+
+        let start = Instant::now();
+        let later = |secs| start + Duration::from_secs(secs);
+        let mut player = Player::new("org.mpris.MediaPlayer2.test", ":1.1");
+        LinuxBackend::decode_properties(&properties, &mut player, start);
+        assert_eq!(player.position_at(later(3)), Some(Duration::from_secs(16)));
+
+        // Pausing freezes the position where it got to.
+        let mut changed = HashMap::new();
+        changed.insert("PlaybackStatus", Value::from("Paused"));
+        LinuxBackend::apply_changes(&mut player, &changed, &[], later(5));
+        assert_eq!(player.position_at(later(60)), Some(Duration::from_secs(20)));
+
+        let session = player.session(later(60)).unwrap();
+        assert_eq!(session.playback_status, PlaybackStatus::Paused);
+        assert_eq!(session.position, Some(Duration::from_secs(20)));
+
+        // A seek reports where playback was just before it.
+        let update = LinuxBackend::apply_seek(&mut player, 4_000_000, later(61));
+        assert!(matches!(
+            update,
+            RawUpdate::Seeked {
+                position,
+                old_position: Some(old),
+            } if position == Duration::from_secs(4) && old == Duration::from_secs(20)
+        ));
+        assert_eq!(player.position_at(later(90)), Some(Duration::from_secs(4)));
+
+        // A new track has to be read again.
+        let mut metadata = HashMap::new();
+        metadata.insert("xesam:title", Value::from("Next"));
+        changed.insert("Metadata", Value::from(metadata));
+        changed.remove("PlaybackStatus");
+        LinuxBackend::apply_changes(&mut player, &changed, &[], later(91));
+        assert!(player.session(later(91)).is_none());
+    }
+
+    #[tokio::test]
+    async fn test_subscribers() {
+        let (sink, mut updates) = crate::platform::events::channel(8);
+        let (gone, _) = crate::platform::events::channel(8);
+
+        let mut subscribers = Subscribers::default();
+        subscribers.add(sink);
+        subscribers.add(gone);
+        subscribers.push(&RawUpdate::SessionClosed);
+        assert_eq!(subscribers.sinks.len(), 1);
+        assert!(matches!(
+            updates.recv().await,
+            Some(RawUpdate::SessionClosed)
+        ));
+
+        subscribers.close();
+        let (late, mut late_updates) = crate::platform::events::channel(8);
+        subscribers.add(late);
+        assert!(late_updates.recv().await.is_none());
+    }
+
+    #[cfg(feature = "mock-mpris")]
+    #[tokio::test]
+    async fn test_backend_creation() {
+        let bus = crate::platform::mock_mpris::MockSessionBus::start()
+            .expect("dbus-daemon must be installed");
+        let backend = bus.backend(Handle::current()).await;
+        assert!(backend.is_ok());
+        assert!(backend.unwrap().get_current().await.unwrap().is_none());
+    }
+
+    #[test]
+    #[ignore = "needs a session bus"]
+    fn test_backends_share_bus() {
+        let rt = tokio::runtime::Runtime::new().unwrap();
+        let first = LinuxBackend::new(rt.handle().clone()).unwrap();
+        let second = LinuxBackend::new(rt.handle().clone()).unwrap();
+        let private = LinuxBackend::with_private_connection(rt.handle().clone()).unwrap();
+        assert!(Arc::ptr_eq(&first.bus, &second.bus));
+        assert!(!Arc::ptr_eq(&first.bus, &private.bus));
+    }
+
+    #[test]
+    #[ignore = "needs a session bus"]
+    fn test_shared_bus_resumes_after_first_runtime() {
+        let first_rt = tokio::runtime::Runtime::new().unwrap();
+        let first = LinuxBackend::new(first_rt.handle().clone()).unwrap();
+        let rt = tokio::runtime::Builder::new_current_thread()
+            .enable_all()
+            .build()
+            .unwrap();
+        let second = LinuxBackend::new(rt.handle().clone()).unwrap();
+        drop(first);
+        drop(first_rt);
+        assert!(!second.bus.is_tracking());
+
+        rt.block_on(second.get_current()).unwrap();
+        assert!(second.bus.is_tracking());
     }
 }
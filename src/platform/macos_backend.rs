@@ -16,12 +16,13 @@
 use std::sync::Arc;
 use std::time::Duration;
 
-use tokio::sync::{RwLock, mpsc};
+use tokio::runtime::Handle;
+use tokio::sync::RwLock;
 
 use super::backend::MediaSessionBackend;
 use crate::error::{MediaError, MediaResult};
-use crate::media_info::{MediaInfo, PlaybackStatus};
-use crate::media_sessions::{MediaSessionEvent, RepeatMode};
+use crate::media_info::MediaInfo;
+use crate::media_sessions::RepeatMode;
 
 /// macOS `MediaRemote` backend.
 #[derive(Clone, Debug)]
@@ -29,81 +30,25 @@ pub struct MacOSBackend {
     #[allow(dead_code)]
     initialized: bool,
     last_info: Arc<RwLock<Option<MediaInfo>>>,
+    #[allow(dead_code)]
+    runtime: Handle,
 }
 
 impl MacOSBackend {
     /// Creates a new macOS backend instance.
-    pub fn new() -> MediaResult<Self> {
+    ///
+    /// `MediaRemote` notifications are not wired up yet, so events come
+    /// from the generic poller; `runtime` is kept for future background
+    /// work.
+    pub fn new(runtime: Handle) -> MediaResult<Self> {
         Ok(Self {
             initialized: true,
             last_info: Arc::new(RwLock::new(None)),
+            runtime,
         })
     }
-
-    /// Polls for media session changes and emits events.
-    async fn poll_events(
-        &self,
-        tx: mpsc::Sender<MediaResult<MediaSessionEvent>>,
-        debounce_duration: Duration,
-    ) {
-        let mut last_status: Option<PlaybackStatus> = None;
-        let mut last_title: Option<String> = None;
-        let mut last_emit_time = tokio::time::Instant::now();
-
-        loop {
-            tokio::time::sleep(Duration::from_millis(500)).await;
-
-            if tx.is_closed() {
-                break;
-            }
-
-            let info = match self.get_current().await {
-                Ok(Some(i)) => i,
-                Ok(None) => {
-                    if last_status.is_some() {
-                        last_status = None;
-                        let _ = tx.send(Ok(MediaSessionEvent::SessionClosed)).await;
-                    }
-                    continue;
-                }
-                Err(e) => {
-                    let _ = tx.send(Err(e)).await;
-                    continue;
-                }
-            };
-
-            // Debounce check
-            let now = tokio::time::Instant::now();
-            if now.duration_since(last_emit_time) < debounce_duration {
-                continue;
-            }
-
-            // Check for metadata changes
-            let title_changed = info.title != last_title;
-            if title_changed {
-                last_title = info.title.clone();
-                let _ = tx
-                    .send(Ok(MediaSessionEvent::MetadataChanged(info.clone())))
-                    .await;
-                last_emit_time = now;
-                continue;
-            }
-
-            // Check for playback status changes
-            if Some(info.playback_status) != last_status {
-                last_status = Some(info.playback_status);
-                let _ = tx
-                    .send(Ok(MediaSessionEvent::PlaybackStatusChanged(
-                        info.playback_status,
-                    )))
-                    .await;
-                last_emit_time = now;
-            }
-        }
-    }
 }
 
-#[async_trait::async_trait]
 impl MediaSessionBackend for MacOSBackend {
     fn platform_name(&self) -> &'static str {
         "macos"
@@ -115,11 +60,11 @@ impl MediaSessionBackend for MacOSBackend {
         Ok(None)
     }
 
-    async fn get_artwork(&self) -> MediaResult<Option<Vec<u8>>> {
+    async fn get_artwork(&self) -> MediaResult<Option<Arc<[u8]>>> {
         Ok(None)
     }
 
-    fn get_active_app(&self) -> MediaResult<Option<String>> {
+    fn get_active_app(&self) -> MediaResult<Option<Arc<str>>> {
         Ok(None)
     }
 
@@ -171,18 +116,6 @@ impl MediaSessionBackend for MacOSBackend {
             message: "Shuffle control requires MediaRemote FFI".to_string(),
         })
     }
-
-    async fn start_listening(
-        &self,
-        tx: mpsc::Sender<MediaResult<MediaSessionEvent>>,
-        debounce_duration: Duration,
-    ) -> MediaResult<()> {
-        let this = self.clone();
-        tokio::spawn(async move {
-            this.poll_events(tx, debounce_duration).await;
-        });
-        Ok(())
-    }
 }
 
 #[cfg(test)]
@@ -191,13 +124,15 @@ mod tests {
 
     #[test]
     fn test_backend_creation() {
-        let result = MacOSBackend::new();
+        let rt = tokio::runtime::Runtime::new().unwrap();
+        let result = MacOSBackend::new(rt.handle().clone());
         assert!(result.is_ok());
     }
 
     #[test]
     fn test_platform_name() {
-        let backend = MacOSBackend::new().unwrap();
+        let rt = tokio::runtime::Runtime::new().unwrap();
+        let backend = MacOSBackend::new(rt.handle().clone()).unwrap();
         assert_eq!(backend.platform_name(), "macos");
     }
 }
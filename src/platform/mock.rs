@@ -0,0 +1,671 @@
+//! In-memory backend for tests and benchmarks.
+//!
+//! [`MockBackend`] behaves like a well-behaved media player without
+//! touching the OS. Plug it in with
+//! [`MediaSessionsBuilder::backend`](crate::MediaSessionsBuilder::backend)
+//! to exercise the full `MediaSessions` stack reproducibly:
+//!
+//! - **Scripted timelines:** session states that take effect at fixed
+//!   offsets, measured from the first call into the backend.
+//! - **Latency injection:** a fixed delay per method.
+//! - **Failure injection:** a method fails always, or for its next few
+//!   calls.
+//! - **Call counters:** how often each method was called.
+//!
+//! Commands change the mocked state the way a player would. Changes are
+//! pushed to [`watch`](crate::MediaSessions::watch) streams, unless
+//! notifications are turned off to exercise the polling path.
+//!
+//! # Examples
+//!
+//! ```rust
+//! use media_sessions::platform::mock::{MockBackend, MockFailure, MockMethod};
+//! use media_sessions::{MediaInfo, MediaSessions, PlaybackStatus};
+//! use std::time::Duration;
+//!
+//! # #[tokio::main]
+//! # async fn main() -> Result<(), Box<dyn std::error::Error>> {
+//! let track = MediaInfo {
+//!     title: Some("Song".into()),
+//!     ..MediaInfo::default()
+//! };
+//! let mock = MockBackend::new()
+//!     .session("mock-player", track.clone())
+//!     .at(
+//!         Duration::from_secs(1),
+//!         Some(MediaInfo {
+//!             playback_status: PlaybackStatus::Paused,
+//!             ..track
+//!         }),
+//!     )
+//!     .latency(MockMethod::GetCurrent, Duration::from_millis(2))
+//!     .fail_times(MockMethod::Play, MockFailure::Timeout, 1);
+//!
+//! let sessions = MediaSessions::builder().backend(mock.clone()).build()?;
+//! assert!(sessions.current().await?.is_some());
+//! assert_eq!(mock.calls(MockMethod::GetCurrent), 1);
+//! # Ok(())
+//! # }
+//! ```
+
+use std::collections::VecDeque;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::{Arc, Mutex, MutexGuard, PoisonError, Weak};
+use std::time::Duration;
+
+use tokio::runtime::Handle;
+use tokio::time::Instant;
+
+use super::backend::MediaSessionBackend;
+use super::events::{EventSink, RawUpdate};
+use crate::error::{MediaError, MediaResult};
+use crate::media_info::{Capabilities, MediaInfo, PlaybackStatus};
+use crate::media_sessions::RepeatMode;
+
+/// Platform name reported by the mock.
+const PLATFORM: &str = "mock";
+
+/// A method of [`MediaSessionBackend`], for injection and counting.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum MockMethod {
+    /// [`MediaSessionBackend::get_current`].
+    GetCurrent,
+    /// [`MediaSessionBackend::get_artwork`].
+    GetArtwork,
+    /// [`MediaSessionBackend::get_active_app`]. Latency is not applied,
+    /// because the method is synchronous.
+    GetActiveApp,
+    /// [`MediaSessionBackend::play`].
+    Play,
+    /// [`MediaSessionBackend::pause`].
+    Pause,
+    /// [`MediaSessionBackend::play_pause`].
+    PlayPause,
+    /// [`MediaSessionBackend::stop`].
+    Stop,
+    /// [`MediaSessionBackend::next`].
+    Next,
+    /// [`MediaSessionBackend::previous`].
+    Previous,
+    /// [`MediaSessionBackend::seek`].
+    Seek,
+    /// [`MediaSessionBackend::set_volume`].
+    SetVolume,
+    /// [`MediaSessionBackend::set_repeat_mode`].
+    SetRepeatMode,
+    /// [`MediaSessionBackend::set_shuffle`].
+    SetShuffle,
+    /// [`MediaSessionBackend::subscribe`].
+    Subscribe,
+}
+
+impl MockMethod {
+    /// Number of methods.
+    const COUNT: usize = 14;
+
+    const fn index(self) -> usize {
+        self as usize
+    }
+}
+
+/// A failure injected into a [`MockBackend`] method.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub enum MockFailure {
+    /// Fails with [`MediaError::Timeout`], like a hung player.
+    Timeout,
+    /// Fails with [`MediaError::Backend`] carrying the message.
+    Backend(String),
+    /// Fails with [`MediaError::NoSession`].
+    NoSession,
+    /// Fails with [`MediaError::NotSupported`].
+    NotSupported,
+}
+
+impl MockFailure {
+    fn to_error(&self) -> MediaError {
+        match self {
+            Self::Timeout => MediaError::Timeout(Duration::ZERO),
+            Self::Backend(message) => MediaError::Backend {
+                platform: PLATFORM.to_string(),
+                message: message.clone(),
+            },
+            Self::NoSession => MediaError::NoSession,
+            Self::NotSupported => MediaError::NotSupported(PLATFORM.to_string()),
+        }
+    }
+}
+
+/// Injected behaviour of one method.
+#[derive(Debug, Clone, Default)]
+struct Behavior {
+    latency: Duration,
+    failure: Option<MockFailure>,
+    /// Remaining failures; `None` fails forever.
+    failures_left: Option<u32>,
+}
+
+/// The mocked player.
+#[derive(Debug, Default)]
+struct State {
+    info: Option<MediaInfo>,
+    app: Option<Arc<str>>,
+    artwork: Option<Arc<[u8]>>,
+    /// Bumped whenever `artwork` is set; the key of the artwork.
+    artwork_version: u64,
+    capabilities: Capabilities,
+    timeline: VecDeque<(Duration, Option<MediaInfo>)>,
+    started: Option<Instant>,
+    sinks: Vec<EventSink>,
+    timeline_driven: bool,
+    /// Runtime for the timeline task; see [`MockBackend::runtime`].
+    runtime: Option<Handle>,
+}
+
+impl State {
+    /// Applies all timeline steps that are due; returns `true` if any was.
+    fn advance(&mut self, now: Instant) -> bool {
+        let started = *self.started.get_or_insert(now);
+        let elapsed = now.saturating_duration_since(started);
+
+        let mut advanced = false;
+        while self
+            .timeline
+            .front()
+            .is_some_and(|(offset, _)| *offset <= elapsed)
+        {
+            if let Some((_, info)) = self.timeline.pop_front() {
+                self.info = info;
+                advanced = true;
+            }
+        }
+        advanced
+    }
+
+    /// Pushes an update to every live subscriber.
+    fn broadcast(&mut self, update: impl Fn() -> RawUpdate) {
+        self.sinks.retain(|sink| sink.push(update()));
+    }
+
+    /// Pushes the full state to every live subscriber.
+    fn broadcast_snapshot(&mut self) {
+        if self.sinks.is_empty() {
+            return;
+        }
+        let info = self.info.clone();
+        self.broadcast(|| RawUpdate::Snapshot(info.clone()));
+    }
+}
+
+#[derive(Debug)]
+struct Inner {
+    state: Mutex<State>,
+    behavior: Mutex<[Behavior; MockMethod::COUNT]>,
+    calls: [AtomicU64; MockMethod::COUNT],
+    notifications: AtomicBool,
+}
+
+/// In-memory [`MediaSessionBackend`] with scripted state, latency and
+/// failure injection, and call counters.
+///
+/// Clones share the same state, so keep a clone to inspect counters or
+/// change the state after handing the backend to
+/// [`MediaSessionsBuilder::backend`](crate::MediaSessionsBuilder::backend).
+#[derive(Debug, Clone)]
+pub struct MockBackend {
+    inner: Arc<Inner>,
+}
+
+impl MockBackend {
+    /// Creates a mock without a session, with no latency and no failures.
+    #[must_use]
+    pub fn new() -> Self {
+        Self {
+            inner: Arc::new(Inner {
+                state: Mutex::new(State::default()),
+                behavior: Mutex::new(Default::default()),
+                calls: Default::default(),
+                notifications: AtomicBool::new(true),
+            }),
+        }
+    }
+
+    /// Starts with an active session of `app_name` playing `info`.
+    #[must_use]
+    pub fn session(self, app_name: impl Into<Arc<str>>, info: MediaInfo) -> Self {
+        {
+            let mut state = self.state();
+            state.app = Some(app_name.into());
+            state.info = Some(info);
+        }
+        self
+    }
+
+    /// Sets the artwork returned by `get_artwork`.
+    #[must_use]
+    pub fn artwork(self, bytes: impl Into<Arc<[u8]>>) -> Self {
+        {
+            let mut state = self.state();
+            state.artwork = Some(bytes.into());
+            state.artwork_version += 1;
+        }
+        self
+    }
+
+    /// Sets the commands the player accepts; the others fail with
+    /// [`MediaError::NotSupported`]. All are accepted by default.
+    #[must_use]
+    pub fn capabilities(self, capabilities: Capabilities) -> Self {
+        self.state().capabilities = capabilities;
+        self
+    }
+
+    /// Schedules the session state to become `info` at `offset` after the
+    /// first call into the backend. `None` closes the session.
+    ///
+    /// Steps must be added in order of their offsets.
+    #[must_use]
+    pub fn at(self, offset: Duration, info: Option<MediaInfo>) -> Self {
+        self.state().timeline.push_back((offset, info));
+        self
+    }
+
+    /// Delays every call of `method` by `latency`.
+    #[must_use]
+    pub fn latency(self, method: MockMethod, latency: Duration) -> Self {
+        self.behavior()[method.index()].latency = latency;
+        self
+    }
+
+    /// Makes every call of `method` fail with `failure`.
+    #[must_use]
+    pub fn fail(self, method: MockMethod, failure: MockFailure) -> Self {
+        {
+            let behavior = &mut self.behavior()[method.index()];
+            behavior.failure = Some(failure);
+            behavior.failures_left = None;
+        }
+        self
+    }
+
+    /// Makes the next `times` calls of `method` fail with `failure`.
+    #[must_use]
+    pub fn fail_times(self, method: MockMethod, failure: MockFailure, times: u32) -> Self {
+        {
+            let behavior = &mut self.behavior()[method.index()];
+            behavior.failure = Some(failure);
+            behavior.failures_left = Some(times);
+        }
+        self
+    }
+
+    /// Plays the timeline out to subscribers on `handle`.
+    ///
+    /// By default, the timeline task is spawned on the runtime that
+    /// `subscribe` is called from, which for `watch` streams is the one
+    /// chosen with [`MediaSessionsBuilder::runtime`], or on the shared
+    /// fallback runtime outside of any.
+    ///
+    /// [`MediaSessionsBuilder::runtime`]: crate::MediaSessionsBuilder::runtime
+    #[must_use]
+    pub fn runtime(self, handle: Handle) -> Self {
+        self.state().runtime = Some(handle);
+        self
+    }
+
+    /// Enables or disables pushed change notifications.
+    ///
+    /// Without notifications, `subscribe` returns
+    /// [`MediaError::NotSupported`] and `watch` streams poll the mock.
+    #[must_use]
+    pub fn notifications(self, enabled: bool) -> Self {
+        self.inner.notifications.store(enabled, Ordering::Relaxed);
+        self
+    }
+
+    /// Replaces the session state now, as if the player changed on its own.
+    pub fn set_state(&self, info: Option<MediaInfo>) {
+        let mut state = self.state();
+        state.info = info;
+        state.broadcast_snapshot();
+    }
+
+    /// Returns how often `method` was called.
+    #[must_use]
+    pub fn calls(&self, method: MockMethod) -> u64 {
+        self.inner.calls[method.index()].load(Ordering::Relaxed)
+    }
+
+    /// Returns how often any method was called.
+    #[must_use]
+    pub fn total_calls(&self) -> u64 {
+        self.inner
+            .calls
+            .iter()
+            .map(|calls| calls.load(Ordering::Relaxed))
+            .sum()
+    }
+
+    /// Resets all call counters to zero.
+    pub fn reset_calls(&self) {
+        for calls in &self.inner.calls {
+            calls.store(0, Ordering::Relaxed);
+        }
+    }
+
+    fn state(&self) -> MutexGuard<'_, State> {
+        self.inner
+            .state
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner)
+    }
+
+    fn behavior(&self) -> MutexGuard<'_, [Behavior; MockMethod::COUNT]> {
+        self.inner
+            .behavior
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner)
+    }
+
+    /// Counts a call and returns its injected failure, if any.
+    fn record_call(&self, method: MockMethod) -> (Duration, Option<MediaError>) {
+        self.inner.calls[method.index()].fetch_add(1, Ordering::Relaxed);
+
+        let mut behaviors = self.behavior();
+        let behavior = &mut behaviors[method.index()];
+        let failure = match (&behavior.failure, behavior.failures_left) {
+            (Some(_), Some(0)) | (None, _) => None,
+            (Some(failure), left) => {
+                behavior.failures_left = left.map(|left| left - 1);
+                Some(failure.to_error())
+            }
+        };
+        let latency = behavior.latency;
+        drop(behaviors);
+        (latency, failure)
+    }
+
+    /// Runs the common part of every async call: counting, latency,
+    /// the timeline, and failure injection.
+    async fn enter(&self, method: MockMethod) -> MediaResult<()> {
+        let (latency, failure) = self.record_call(method);
+        if !latency.is_zero() {
+            tokio::time::sleep(latency).await;
+        }
+
+        let mut state = self.state();
+        if state.advance(Instant::now()) {
+            state.broadcast_snapshot();
+        }
+        drop(state);
+        failure.map_or(Ok(()), Err)
+    }
+
+    /// Fails the way a player does that does not accept a command.
+    fn require(&self, supported: impl FnOnce(&Capabilities) -> bool) -> MediaResult<()> {
+        if supported(&self.state().capabilities) {
+            Ok(())
+        } else {
+            Err(MediaError::NotSupported(PLATFORM.to_string()))
+        }
+    }
+
+    /// Changes the active session, failing without one.
+    fn update_session(&self, update: impl FnOnce(&mut MediaInfo)) -> MediaResult<()> {
+        let mut state = self.state();
+        let info = state.info.as_mut().ok_or(MediaError::NoSession)?;
+        update(info);
+        state.broadcast_snapshot();
+        drop(state);
+        Ok(())
+    }
+
+    /// Plays the timeline out to subscribers, in real time, on `runtime`.
+    fn drive_timeline(inner: Weak<Inner>, runtime: &Handle) {
+        runtime.spawn(async move {
+            loop {
+                let wake_at = {
+                    let Some(inner) = inner.upgrade() else {
+                        return;
+                    };
+                    let state = inner.state.lock().unwrap_or_else(PoisonError::into_inner);
+                    match (state.started, state.timeline.front()) {
+                        (Some(started), Some((offset, _))) => started + *offset,
+                        _ => return,
+                    }
+                };
+                tokio::time::sleep_until(wake_at).await;
+
+                let Some(inner) = inner.upgrade() else {
+                    return;
+                };
+                let mut state = inner.state.lock().unwrap_or_else(PoisonError::into_inner);
+                if state.advance(Instant::now()) {
+                    state.broadcast_snapshot();
+                }
+            }
+        });
+    }
+}
+
+impl Default for MockBackend {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl MediaSessionBackend for MockBackend {
+    fn platform_name(&self) -> &'static str {
+        PLATFORM
+    }
+
+    async fn get_current(&self) -> MediaResult<Option<MediaInfo>> {
+        self.enter(MockMethod::GetCurrent).await?;
+        Ok(self.state().info.clone())
+    }
+
+    async fn get_artwork(&self) -> MediaResult<Option<Arc<[u8]>>> {
+        self.enter(MockMethod::GetArtwork).await?;
+        let state = self.state();
+        Ok(state.info.as_ref().and_then(|_| state.artwork.clone()))
+    }
+
+    async fn artwork_key(&self) -> MediaResult<Option<u64>> {
+        Ok(Some(self.state().artwork_version))
+    }
+
+    fn capabilities(&self) -> MediaResult<Option<Capabilities>> {
+        let state = self.state();
+        Ok(state.info.as_ref().map(|_| state.capabilities))
+    }
+
+    fn get_active_app(&self) -> MediaResult<Option<Arc<str>>> {
+        let (_, failure) = self.record_call(MockMethod::GetActiveApp);
+        if let Some(err) = failure {
+            return Err(err);
+        }
+
+        let mut state = self.state();
+        if state.advance(Instant::now()) {
+            state.broadcast_snapshot();
+        }
+        Ok(state.info.as_ref().and_then(|_| state.app.clone()))
+    }
+
+    async fn play(&self) -> MediaResult<()> {
+        self.enter(MockMethod::Play).await?;
+        self.require(|can| can.can_play)?;
+        self.update_session(|info| info.playback_status = PlaybackStatus::Playing)
+    }
+
+    async fn pause(&self) -> MediaResult<()> {
+        self.enter(MockMethod::Pause).await?;
+        self.require(|can| can.can_pause)?;
+        self.update_session(|info| info.playback_status = PlaybackStatus::Paused)
+    }
+
+    async fn play_pause(&self) -> MediaResult<()> {
+        self.enter(MockMethod::PlayPause).await?;
+        self.require(|can| can.can_pause)?;
+        self.update_session(|info| {
+            info.playback_status = if info.playback_status.is_playing() {
+                PlaybackStatus::Paused
+            } else {
+                PlaybackStatus::Playing
+            };
+        })
+    }
+
+    async fn stop(&self) -> MediaResult<()> {
+        self.enter(MockMethod::Stop).await?;
+        self.require(|can| can.can_control)?;
+        self.update_session(|info| {
+            info.playback_status = PlaybackStatus::Stopped;
+            info.position = Some(Duration::ZERO);
+        })
+    }
+
+    async fn next(&self) -> MediaResult<()> {
+        self.enter(MockMethod::Next).await?;
+        self.require(|can| can.can_go_next)?;
+        self.update_session(|info| info.position = Some(Duration::ZERO))
+    }
+
+    async fn previous(&self) -> MediaResult<()> {
+        self.enter(MockMethod::Previous).await?;
+        self.require(|can| can.can_go_previous)?;
+        self.update_session(|info| info.position = Some(Duration::ZERO))
+    }
+
+    async fn seek(&self, position: Duration) -> MediaResult<()> {
+        self.enter(MockMethod::Seek).await?;
+        self.require(|can| can.can_seek)?;
+        self.update_session(|info| info.position = Some(position))
+    }
+
+    async fn set_volume(&self, volume: f64) -> MediaResult<()> {
+        self.enter(MockMethod::SetVolume).await?;
+        self.require(|can| can.can_control)?;
+        self.state().broadcast(|| RawUpdate::Volume(volume));
+        Ok(())
+    }
+
+    async fn set_repeat_mode(&self, mode: RepeatMode) -> MediaResult<()> {
+        self.enter(MockMethod::SetRepeatMode).await?;
+        self.require(|can| can.can_control)?;
+        self.state().broadcast(|| RawUpdate::RepeatMode(mode));
+        Ok(())
+    }
+
+    async fn set_shuffle(&self, enabled: bool) -> MediaResult<()> {
+        self.enter(MockMethod::SetShuffle).await?;
+        self.require(|can| can.can_control)?;
+        self.state().broadcast(|| RawUpdate::Shuffle(enabled));
+        Ok(())
+    }
+
+    async fn subscribe(&self, sink: EventSink) -> MediaResult<()> {
+        if !self.inner.notifications.load(Ordering::Relaxed) {
+            return Err(MediaError::NotSupported(PLATFORM.to_string()));
+        }
+
+        self.enter(MockMethod::Subscribe).await?;
+
+        let mut state = self.state();
+        if !state.timeline_driven && !state.timeline.is_empty() {
+            let runtime = crate::runtime::resolve(state.runtime.clone())?;
+            state.timeline_driven = true;
+            Self::drive_timeline(Arc::downgrade(&self.inner), &runtime);
+        }
+        state.sinks.push(sink);
+        drop(state);
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn track(status: PlaybackStatus) -> MediaInfo {
+        MediaInfo {
+            title: Some("Track".into()),
+            playback_status: status,
+            ..MediaInfo::default()
+        }
+    }
+
+    #[tokio::test]
+    async fn test_commands_change_state() {
+        let mock = MockBackend::new().session("mock", track(PlaybackStatus::Playing));
+
+        mock.pause().await.unwrap();
+        mock.seek(Duration::from_secs(42)).await.unwrap();
+
+        let info = mock.get_current().await.unwrap().unwrap();
+        assert_eq!(info.playback_status, PlaybackStatus::Paused);
+        assert_eq!(info.position, Some(Duration::from_secs(42)));
+        assert_eq!(mock.calls(MockMethod::Pause), 1);
+        assert_eq!(mock.total_calls(), 3);
+    }
+
+    #[tokio::test]
+    async fn test_failure_injection() {
+        let mock = MockBackend::new()
+            .session("mock", track(PlaybackStatus::Playing))
+            .fail_times(MockMethod::Play, MockFailure::Timeout, 2);
+
+        assert!(matches!(mock.play().await, Err(MediaError::Timeout(_))));
+        assert!(matches!(mock.play().await, Err(MediaError::Timeout(_))));
+        assert!(mock.play().await.is_ok());
+        assert_eq!(mock.calls(MockMethod::Play), 3);
+
+        let mock = mock.fail(MockMethod::Next, MockFailure::NoSession);
+        for _ in 0..3 {
+            assert!(matches!(mock.next().await, Err(MediaError::NoSession)));
+        }
+    }
+
+    #[tokio::test]
+    async fn test_timeline() {
+        let mock = MockBackend::new()
+            .session("mock", track(PlaybackStatus::Playing))
+            .at(Duration::ZERO, Some(track(PlaybackStatus::Paused)))
+            .at(Duration::from_secs(3600), None);
+
+        let info = mock.get_current().await.unwrap().unwrap();
+        assert_eq!(info.playback_status, PlaybackStatus::Paused);
+        assert_eq!(mock.get_active_app().unwrap().as_deref(), Some("mock"));
+    }
+
+    #[test]
+    fn test_timeline_runs_on_given_runtime() {
+        let rt = tokio::runtime::Builder::new_current_thread()
+            .enable_all()
+            .build()
+            .unwrap();
+        let mock = MockBackend::new()
+            .session("mock", track(PlaybackStatus::Playing))
+            .at(
+                Duration::from_millis(10),
+                Some(track(PlaybackStatus::Paused)),
+            )
+            .runtime(rt.handle().clone());
+
+        // Subscribing outside of any runtime does not panic.
+        let (sink, mut updates) = crate::platform::events::channel(8);
+        futures::executor::block_on(mock.subscribe(sink)).unwrap();
+
+        let update = rt.block_on(updates.recv()).unwrap();
+        let RawUpdate::Snapshot(Some(info)) = update else {
+            panic!("expected a snapshot, got {update:?}");
+        };
+        assert_eq!(info.playback_status, PlaybackStatus::Paused);
+    }
+
+    #[tokio::test]
+    async fn test_commands_without_session() {
+        let mock = MockBackend::new();
+        assert!(matches!(mock.play().await, Err(MediaError::NoSession)));
+        assert!(mock.get_current().await.unwrap().is_none());
+    }
+}
@@ -0,0 +1,937 @@
+//! Fake MPRIS players on a private session bus, for tests and benchmarks.
+//!
+//! [`MockSessionBus`] starts a `dbus-daemon --session` of its own, so the
+//! Linux backend can be exercised end to end without a desktop session or
+//! a real media player, on a headless CI machine:
+//!
+//! - **Private bus:** the daemon listens on a fresh socket and is killed
+//!   when the bus is dropped; nothing on the user's session bus is seen.
+//! - **Fake players:** [`MockMprisPlayer`] serves the MPRIS
+//!   `org.mpris.MediaPlayer2` and `org.mpris.MediaPlayer2.Player`
+//!   interfaces with zbus, from a connection of its own.
+//! - **Scripted state:** metadata, playback status, capabilities and
+//!   position are set from the test, and announced with
+//!   `PropertiesChanged` and `Seeked` like a real player does.
+//! - **Response delays:** a fixed delay before every method call or
+//!   property write is answered.
+//! - **Call counters:** how often each method was called, each property
+//!   written, and the player's properties read with `Get` or `GetAll`.
+//!
+//! Commands change the player state the way a player would: `Play` starts
+//! playback, `Seek` moves the position and emits `Seeked`, writing
+//! `Volume` emits `PropertiesChanged`, and so on.
+//!
+//! Only `dbus-daemon` has to be installed; it comes with the `dbus`
+//! package on every common distribution.
+//!
+//! # Examples
+//!
+//! ```rust,no_run
+//! use media_sessions::platform::mock_mpris::MockSessionBus;
+//! use media_sessions::{MediaInfo, MediaSessions};
+//!
+//! # #[tokio::main]
+//! # async fn main() -> Result<(), Box<dyn std::error::Error>> {
+//! let bus = MockSessionBus::start()?;
+//! let player = bus
+//!     .spawn_player(
+//!         "fake",
+//!         MediaInfo {
+//!             title: Some("Song".into()),
+//!             ..MediaInfo::default()
+//!         },
+//!     )
+//!     .await?;
+//!
+//! let sessions = MediaSessions::builder()
+//!     .build_with(bus.backend(tokio::runtime::Handle::current()).await?)?;
+//! sessions.play().await?;
+//! assert_eq!(player.calls("Play"), 1);
+//! # Ok(())
+//! # }
+//! ```
+
+use std::collections::HashMap;
+use std::io::{BufRead, BufReader};
+use std::process::{Child, Command, Stdio};
+use std::sync::{Arc, Mutex, MutexGuard, PoisonError};
+use std::time::{Duration, Instant};
+
+use futures::StreamExt;
+use tokio::runtime::Handle;
+use tokio::task::AbortHandle;
+use zbus::object_server::{InterfaceRef, SignalContext};
+use zbus::zvariant::{ObjectPath, OwnedObjectPath, OwnedValue, Value};
+
+use super::linux_backend::LinuxBackend;
+use crate::error::{MediaError, MediaResult};
+use crate::media_info::{Capabilities, MediaInfo, PlaybackStatus};
+use crate::media_sessions::RepeatMode;
+
+/// Prefix of MPRIS player bus names.
+const MPRIS_SERVICE_PREFIX: &str = "org.mpris.MediaPlayer2.";
+
+/// Object path of the MPRIS interfaces.
+const MPRIS_PATH: &str = "/org/mpris/MediaPlayer2";
+
+/// Interface of the standard `Get`, `GetAll` and `Set` property calls.
+const PROPERTIES_INTERFACE: &str = "org.freedesktop.DBus.Properties";
+
+/// Prefix of the track ids handed out by fake players.
+const TRACK_PATH: &str = "/org/mpris/MediaPlayer2/Track";
+
+/// Wraps a zbus error with what was being done.
+fn dbus_error(action: &str) -> impl FnOnce(zbus::Error) -> MediaError + '_ {
+    move |e| MediaError::DBusError(format!("{action}: {e}"))
+}
+
+/// A private `dbus-daemon`, killed when dropped.
+///
+/// Every bus is independent, so tests using separate buses can run in
+/// parallel.
+#[derive(Debug)]
+pub struct MockSessionBus {
+    daemon: Child,
+    address: String,
+}
+
+impl MockSessionBus {
+    /// Starts a session bus daemon listening on a fresh socket in the
+    /// temporary directory.
+    ///
+    /// This waits until the daemon has printed its address, which takes a
+    /// few milliseconds.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if `dbus-daemon` is not installed
+    /// or fails to start.
+    pub fn start() -> MediaResult<Self> {
+        let start_error =
+            |e: std::io::Error| MediaError::DBusError(format!("Failed to start dbus-daemon: {e}"));
+        let mut daemon = Command::new("dbus-daemon")
+            .arg("--session")
+            .arg("--nofork")
+            .arg("--nopidfile")
+            .arg("--print-address")
+            .arg(format!(
+                "--address=unix:tmpdir={}",
+                std::env::temp_dir().display()
+            ))
+            .stdin(Stdio::null())
+            .stdout(Stdio::piped())
+            .stderr(Stdio::null())
+            .spawn()
+            .map_err(start_error)?;
+
+        let mut address = String::new();
+        let read = daemon.stdout.take().map_or(Ok(0), |stdout| {
+            BufReader::new(stdout).read_line(&mut address)
+        });
+        let bus = Self {
+            daemon,
+            address: address.trim().to_string(),
+        };
+        match read {
+            Ok(_) if !bus.address.is_empty() => Ok(bus),
+            Ok(_) => Err(MediaError::DBusError(
+                "dbus-daemon exited without printing its address".to_string(),
+            )),
+            Err(e) => Err(start_error(e)),
+        }
+    }
+
+    /// Returns the D-Bus address of the bus.
+    #[must_use]
+    pub fn address(&self) -> &str {
+        &self.address
+    }
+
+    /// Opens a new connection to the bus.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the bus cannot be reached.
+    pub async fn connect(&self) -> MediaResult<zbus::Connection> {
+        zbus::connection::Builder::address(self.address.as_str())
+            .map_err(dbus_error("Invalid bus address"))?
+            .build()
+            .await
+            .map_err(dbus_error("Failed to connect to the mock bus"))
+    }
+
+    /// Creates a Linux backend on a connection of its own to this bus.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the bus cannot be reached.
+    pub async fn backend(&self, runtime: Handle) -> MediaResult<LinuxBackend> {
+        LinuxBackend::with_connection(self.connect().await?, runtime).await
+    }
+
+    /// Puts a fake player named `org.mpris.MediaPlayer2.<name>` on the bus,
+    /// playing `info`.
+    ///
+    /// The player stays on the bus until it is dropped. Response delays
+    /// run on the current Tokio runtime.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the bus cannot be reached or
+    /// the name is taken.
+    ///
+    /// # Panics
+    ///
+    /// Panics if called outside of a Tokio runtime.
+    pub async fn spawn_player(&self, name: &str, info: MediaInfo) -> MediaResult<MockMprisPlayer> {
+        let bus_name = format!("{MPRIS_SERVICE_PREFIX}{name}");
+        let script = Arc::new(Mutex::new(Script::new(info)));
+
+        let connection = zbus::connection::Builder::address(self.address.as_str())
+            .and_then(|builder| builder.name(bus_name.clone()))
+            .and_then(|builder| {
+                builder.serve_at(
+                    MPRIS_PATH,
+                    RootInterface {
+                        identity: name.to_string(),
+                    },
+                )
+            })
+            .and_then(|builder| {
+                builder.serve_at(
+                    MPRIS_PATH,
+                    PlayerInterface {
+                        script: Arc::clone(&script),
+                        runtime: Handle::current(),
+                    },
+                )
+            })
+            .map_err(dbus_error("Failed to set up the mock player"))?
+            .build()
+            .await
+            .map_err(dbus_error("Failed to start the mock player"))?;
+
+        // Property reads are answered by zbus itself, so they are counted
+        // from a copy of the incoming calls.
+        let rule = zbus::MatchRule::builder()
+            .msg_type(zbus::message::Type::MethodCall)
+            .interface(PROPERTIES_INTERFACE)
+            .and_then(|rule| rule.path(MPRIS_PATH))
+            .map_err(dbus_error("Invalid match rule"))?
+            .build();
+        let mut reads = zbus::MessageStream::for_match_rule(rule, &connection, None)
+            .await
+            .map_err(dbus_error("Failed to watch property reads"))?;
+        let script_reads = Arc::clone(&script);
+        let counter = Handle::current().spawn(async move {
+            while let Some(Ok(message)) = reads.next().await {
+                let member = match message
+                    .header()
+                    .member()
+                    .map(zbus::names::MemberName::as_str)
+                {
+                    Some("Get") => "Get",
+                    Some("GetAll") => "GetAll",
+                    _ => continue,
+                };
+                *lock(&script_reads).calls.entry(member).or_default() += 1;
+            }
+        });
+
+        Ok(MockMprisPlayer {
+            bus_name,
+            connection,
+            script,
+            _reads: ReadCounter(counter.abort_handle()),
+        })
+    }
+}
+
+impl Drop for MockSessionBus {
+    fn drop(&mut self) {
+        // The daemon may have exited already; there is nothing left to do
+        // about it either way.
+        let _ = self.daemon.kill();
+        let _ = self.daemon.wait();
+    }
+}
+
+/// State of a fake player, shared by its interfaces and its handle.
+#[derive(Debug)]
+struct Script {
+    /// Track fields; playback status and position are kept apart.
+    track: MediaInfo,
+    /// Number of the current track, for its `mpris:trackid`.
+    track_number: u64,
+    status: PlaybackStatus,
+    /// Position at `position_at`, advancing at `rate` while playing.
+    position: Duration,
+    position_at: Instant,
+    rate: f64,
+    volume: f64,
+    repeat: RepeatMode,
+    shuffle: bool,
+    capabilities: Capabilities,
+    /// Delay before a method call or property write is answered.
+    delay: Duration,
+    /// Method calls, property writes and property reads, by D-Bus member
+    /// name.
+    calls: HashMap<&'static str, u64>,
+}
+
+impl Script {
+    fn new(info: MediaInfo) -> Self {
+        let mut script = Self {
+            track: MediaInfo::default(),
+            track_number: 0,
+            status: PlaybackStatus::Stopped,
+            position: Duration::ZERO,
+            position_at: Instant::now(),
+            rate: 1.0,
+            volume: 1.0,
+            repeat: RepeatMode::None,
+            shuffle: false,
+            capabilities: Capabilities::default(),
+            delay: Duration::ZERO,
+            calls: HashMap::new(),
+        };
+        script.load(info);
+        script
+    }
+
+    /// Switches to the track of `info`, with a new track id, taking over
+    /// its playback status and position.
+    fn load(&mut self, info: MediaInfo) {
+        self.status = info.playback_status;
+        self.set_position(info.position.unwrap_or_default());
+        self.track = MediaInfo {
+            position: None,
+            playback_status: PlaybackStatus::default(),
+            ..info
+        };
+        self.track_number += 1;
+    }
+
+    /// Returns the `mpris:trackid` of the current track.
+    fn track_id(&self) -> String {
+        format!("{TRACK_PATH}/{}", self.track_number)
+    }
+
+    /// Returns the position now, capped at the track length.
+    fn position(&self) -> Duration {
+        let mut position = self.position;
+        if self.status == PlaybackStatus::Playing {
+            let elapsed = self.position_at.elapsed().as_secs_f64() * self.rate;
+            position += Duration::try_from_secs_f64(elapsed).unwrap_or_default();
+        }
+        self.track
+            .duration
+            .map_or(position, |length| position.min(length))
+    }
+
+    /// Moves the position to `position`.
+    fn set_position(&mut self, position: Duration) {
+        self.position = position;
+        self.position_at = Instant::now();
+    }
+
+    /// Changes the playback status, keeping the position.
+    fn set_status(&mut self, status: PlaybackStatus) {
+        let position = match status {
+            PlaybackStatus::Stopped => Duration::ZERO,
+            _ => self.position(),
+        };
+        self.status = status;
+        self.set_position(position);
+    }
+
+    /// Builds the `Metadata` property.
+    fn metadata(&self) -> HashMap<String, OwnedValue> {
+        let track = &self.track;
+        let track_id = self.track_id();
+        let mut values: Vec<(&str, Value<'_>)> = Vec::new();
+        if let Ok(path) = ObjectPath::try_from(track_id.as_str()) {
+            values.push(("mpris:trackid", Value::from(path)));
+        }
+        if let Some(title) = track.title.as_deref() {
+            values.push(("xesam:title", Value::from(title)));
+        }
+        if let Some(artist) = track.artist.as_deref() {
+            values.push(("xesam:artist", Value::from(vec![artist])));
+        }
+        if let Some(album) = track.album.as_deref() {
+            values.push(("xesam:album", Value::from(album)));
+        }
+        if let Some(genre) = track.genre.as_deref() {
+            values.push(("xesam:genre", Value::from(vec![genre])));
+        }
+        if let Some(url) = track.url.as_deref() {
+            values.push(("xesam:url", Value::from(url)));
+        }
+        if let Some(art_url) = track.thumbnail_url.as_deref() {
+            values.push(("mpris:artUrl", Value::from(art_url)));
+        }
+        if let Some(length) = track.duration {
+            values.push(("mpris:length", Value::from(micros(length))));
+        }
+        if let Some(number) = track.track_number.and_then(|n| i32::try_from(n).ok()) {
+            values.push(("xesam:trackNumber", Value::from(number)));
+        }
+        if let Some(number) = track.disc_number.and_then(|n| i32::try_from(n).ok()) {
+            values.push(("xesam:discNumber", Value::from(number)));
+        }
+        if let Some(year) = track.year {
+            values.push((
+                "xesam:contentCreated",
+                Value::from(format!("{year:04}-01-01")),
+            ));
+        }
+
+        values
+            .into_iter()
+            .filter_map(|(key, value)| Some((key.to_string(), value.try_to_owned().ok()?)))
+            .collect()
+    }
+}
+
+/// Converts a duration to MPRIS microseconds.
+fn micros(duration: Duration) -> i64 {
+    i64::try_from(duration.as_micros()).unwrap_or(i64::MAX)
+}
+
+/// Converts MPRIS microseconds to a duration, clamping negative values
+/// to zero.
+fn from_micros(micros: i64) -> Duration {
+    Duration::from_micros(u64::try_from(micros).unwrap_or(0))
+}
+
+fn lock(script: &Mutex<Script>) -> MutexGuard<'_, Script> {
+    script.lock().unwrap_or_else(PoisonError::into_inner)
+}
+
+/// The `org.mpris.MediaPlayer2` interface of a fake player.
+struct RootInterface {
+    identity: String,
+}
+
+// zbus calls these with a receiver, whether they use it or not.
+#[allow(clippy::unused_self, clippy::missing_const_for_fn)]
+#[zbus::interface(name = "org.mpris.MediaPlayer2")]
+impl RootInterface {
+    fn raise(&self) {}
+
+    fn quit(&self) {}
+
+    #[zbus(property)]
+    fn can_quit(&self) -> bool {
+        false
+    }
+
+    #[zbus(property)]
+    fn can_raise(&self) -> bool {
+        false
+    }
+
+    #[zbus(property)]
+    fn has_track_list(&self) -> bool {
+        false
+    }
+
+    #[zbus(property)]
+    fn identity(&self) -> String {
+        self.identity.clone()
+    }
+
+    #[zbus(property)]
+    fn supported_uri_schemes(&self) -> Vec<String> {
+        Vec::new()
+    }
+
+    #[zbus(property)]
+    fn supported_mime_types(&self) -> Vec<String> {
+        Vec::new()
+    }
+}
+
+/// The `org.mpris.MediaPlayer2.Player` interface of a fake player.
+struct PlayerInterface {
+    script: Arc<Mutex<Script>>,
+    /// Runtime the response delays are timed on.
+    runtime: Handle,
+}
+
+impl PlayerInterface {
+    /// Counts a call of `member` and waits for the response delay.
+    async fn respond(&self, member: &'static str) {
+        let delay = {
+            let mut script = lock(&self.script);
+            *script.calls.entry(member).or_default() += 1;
+            script.delay
+        };
+        if !delay.is_zero() {
+            // zbus may run the interface on its own executor, without a
+            // Tokio timer, so the delay is timed on the player's runtime.
+            let _ = self.runtime.spawn(tokio::time::sleep(delay)).await;
+        }
+    }
+
+    /// Changes the playback status and announces it.
+    async fn change_status(
+        &self,
+        ctxt: &SignalContext<'_>,
+        status: PlaybackStatus,
+    ) -> zbus::fdo::Result<()> {
+        let changed = {
+            let mut script = lock(&self.script);
+            let changed = script.status != status;
+            script.set_status(status);
+            changed
+        };
+        if changed {
+            self.playback_status_changed(ctxt).await?;
+        }
+        Ok(())
+    }
+
+    /// Moves the position and emits `Seeked`.
+    async fn move_to(&self, ctxt: &SignalContext<'_>, position: Duration) -> zbus::fdo::Result<()> {
+        let position = {
+            let mut script = lock(&self.script);
+            let position = script
+                .track
+                .duration
+                .map_or(position, |length| position.min(length));
+            script.set_position(position);
+            position
+        };
+        Self::seeked(ctxt, micros(position)).await?;
+        Ok(())
+    }
+}
+
+// zbus calls these with a receiver, and property setters take it mutably.
+#[allow(
+    clippy::unused_self,
+    clippy::missing_const_for_fn,
+    clippy::needless_pass_by_ref_mut
+)]
+#[zbus::interface(name = "org.mpris.MediaPlayer2.Player")]
+impl PlayerInterface {
+    async fn play(&self, #[zbus(signal_context)] ctxt: SignalContext<'_>) -> zbus::fdo::Result<()> {
+        self.respond("Play").await;
+        self.change_status(&ctxt, PlaybackStatus::Playing).await
+    }
+
+    async fn pause(
+        &self,
+        #[zbus(signal_context)] ctxt: SignalContext<'_>,
+    ) -> zbus::fdo::Result<()> {
+        self.respond("Pause").await;
+        self.change_status(&ctxt, PlaybackStatus::Paused).await
+    }
+
+    async fn play_pause(
+        &self,
+        #[zbus(signal_context)] ctxt: SignalContext<'_>,
+    ) -> zbus::fdo::Result<()> {
+        self.respond("PlayPause").await;
+        let current = lock(&self.script).status;
+        let status = match current {
+            PlaybackStatus::Playing => PlaybackStatus::Paused,
+            _ => PlaybackStatus::Playing,
+        };
+        self.change_status(&ctxt, status).await
+    }
+
+    async fn stop(&self, #[zbus(signal_context)] ctxt: SignalContext<'_>) -> zbus::fdo::Result<()> {
+        self.respond("Stop").await;
+        self.change_status(&ctxt, PlaybackStatus::Stopped).await
+    }
+
+    async fn next(&self) {
+        self.respond("Next").await;
+    }
+
+    async fn previous(&self) {
+        self.respond("Previous").await;
+    }
+
+    async fn seek(
+        &self,
+        offset: i64,
+        #[zbus(signal_context)] ctxt: SignalContext<'_>,
+    ) -> zbus::fdo::Result<()> {
+        self.respond("Seek").await;
+        let position = micros(lock(&self.script).position()).saturating_add(offset);
+        self.move_to(&ctxt, from_micros(position)).await
+    }
+
+    async fn set_position(
+        &self,
+        track_id: OwnedObjectPath,
+        position: i64,
+        #[zbus(signal_context)] ctxt: SignalContext<'_>,
+    ) -> zbus::fdo::Result<()> {
+        self.respond("SetPosition").await;
+        // As the specification asks, stale track ids and positions outside
+        // the track are ignored.
+        let current = {
+            let script = lock(&self.script);
+            track_id.as_str() == script.track_id()
+                && position >= 0
+                && script
+                    .track
+                    .duration
+                    .map_or(true, |length| from_micros(position) <= length)
+        };
+        if current {
+            self.move_to(&ctxt, from_micros(position)).await?;
+        }
+        Ok(())
+    }
+
+    async fn open_uri(&self, _uri: String) {
+        self.respond("OpenUri").await;
+    }
+
+    #[zbus(signal)]
+    async fn seeked(ctxt: &SignalContext<'_>, position: i64) -> zbus::Result<()>;
+
+    #[zbus(property)]
+    fn playback_status(&self) -> String {
+        let current = lock(&self.script).status;
+        let status = match current {
+            PlaybackStatus::Playing => "Playing",
+            PlaybackStatus::Paused => "Paused",
+            PlaybackStatus::Stopped | PlaybackStatus::Transitioning => "Stopped",
+        };
+        status.to_string()
+    }
+
+    #[zbus(property)]
+    fn loop_status(&self) -> String {
+        let current = lock(&self.script).repeat;
+        let repeat = match current {
+            RepeatMode::None => "None",
+            RepeatMode::One => "Track",
+            RepeatMode::All => "Playlist",
+        };
+        repeat.to_string()
+    }
+
+    #[zbus(property)]
+    async fn set_loop_status(&mut self, value: String) {
+        self.respond("LoopStatus").await;
+        let repeat = match value.as_str() {
+            "Track" => RepeatMode::One,
+            "Playlist" => RepeatMode::All,
+            _ => RepeatMode::None,
+        };
+        lock(&self.script).repeat = repeat;
+    }
+
+    #[zbus(property)]
+    fn rate(&self) -> f64 {
+        lock(&self.script).rate
+    }
+
+    #[zbus(property)]
+    fn shuffle(&self) -> bool {
+        lock(&self.script).shuffle
+    }
+
+    #[zbus(property)]
+    async fn set_shuffle(&mut self, value: bool) {
+        self.respond("Shuffle").await;
+        lock(&self.script).shuffle = value;
+    }
+
+    #[zbus(property)]
+    fn metadata(&self) -> HashMap<String, OwnedValue> {
+        lock(&self.script).metadata()
+    }
+
+    #[zbus(property)]
+    fn volume(&self) -> f64 {
+        lock(&self.script).volume
+    }
+
+    #[zbus(property)]
+    async fn set_volume(&mut self, value: f64) {
+        self.respond("Volume").await;
+        lock(&self.script).volume = value.clamp(0.0, 1.0);
+    }
+
+    #[zbus(property(emits_changed_signal = "false"))]
+    fn position(&self) -> i64 {
+        micros(lock(&self.script).position())
+    }
+
+    #[zbus(property)]
+    fn minimum_rate(&self) -> f64 {
+        1.0
+    }
+
+    #[zbus(property)]
+    fn maximum_rate(&self) -> f64 {
+        1.0
+    }
+
+    #[zbus(property)]
+    fn can_go_next(&self) -> bool {
+        lock(&self.script).capabilities.can_go_next
+    }
+
+    #[zbus(property)]
+    fn can_go_previous(&self) -> bool {
+        lock(&self.script).capabilities.can_go_previous
+    }
+
+    #[zbus(property)]
+    fn can_play(&self) -> bool {
+        lock(&self.script).capabilities.can_play
+    }
+
+    #[zbus(property)]
+    fn can_pause(&self) -> bool {
+        lock(&self.script).capabilities.can_pause
+    }
+
+    #[zbus(property)]
+    fn can_seek(&self) -> bool {
+        lock(&self.script).capabilities.can_seek
+    }
+
+    #[zbus(property)]
+    fn can_control(&self) -> bool {
+        lock(&self.script).capabilities.can_control
+    }
+}
+
+/// Stops counting property reads when the player goes away; the task
+/// would otherwise keep its connection open.
+#[derive(Debug)]
+struct ReadCounter(AbortHandle);
+
+impl Drop for ReadCounter {
+    fn drop(&mut self) {
+        self.0.abort();
+    }
+}
+
+/// A fake MPRIS player on a [`MockSessionBus`].
+///
+/// The player is removed from the bus when this is dropped.
+#[derive(Debug)]
+pub struct MockMprisPlayer {
+    bus_name: String,
+    connection: zbus::Connection,
+    script: Arc<Mutex<Script>>,
+    _reads: ReadCounter,
+}
+
+impl MockMprisPlayer {
+    /// Returns the bus name of the player, e.g.
+    /// `org.mpris.MediaPlayer2.fake`.
+    #[must_use]
+    pub fn bus_name(&self) -> &str {
+        &self.bus_name
+    }
+
+    /// Delays the answer to every method call and property write by
+    /// `delay`. Property reads are answered at once.
+    pub fn set_delay(&self, delay: Duration) {
+        self.script().delay = delay;
+    }
+
+    /// Returns how often the method or property called `member` (such as
+    /// `"Play"` or `"Volume"`) was called or written.
+    ///
+    /// `"Get"` and `"GetAll"` count property reads. They are counted off
+    /// the call path and may trail the reply by a moment.
+    #[must_use]
+    pub fn calls(&self, member: &str) -> u64 {
+        self.script().calls.get(member).copied().unwrap_or(0)
+    }
+
+    /// Returns the playback status.
+    #[must_use]
+    pub fn playback_status(&self) -> PlaybackStatus {
+        self.script().status
+    }
+
+    /// Returns the playback position.
+    #[must_use]
+    pub fn position(&self) -> Duration {
+        self.script().position()
+    }
+
+    /// Returns the volume.
+    #[must_use]
+    pub fn volume(&self) -> f64 {
+        self.script().volume
+    }
+
+    /// Returns the repeat mode.
+    #[must_use]
+    pub fn repeat_mode(&self) -> RepeatMode {
+        self.script().repeat
+    }
+
+    /// Returns whether shuffle is on.
+    #[must_use]
+    pub fn shuffle(&self) -> bool {
+        self.script().shuffle
+    }
+
+    /// Switches to a new track described by `info`, with a new track id,
+    /// and announces it with `PropertiesChanged`.
+    ///
+    /// The playback status and position of `info` are taken over as well.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the signal cannot be sent.
+    pub async fn set_metadata(&self, info: MediaInfo) -> MediaResult<()> {
+        self.script().load(info);
+        let player = self.interface().await?;
+        let context = player.signal_context();
+        let interface = player.get().await;
+        interface
+            .metadata_changed(context)
+            .await
+            .and(interface.playback_status_changed(context).await)
+            .map_err(dbus_error("Failed to announce metadata"))
+    }
+
+    /// Changes the playback status and announces it with
+    /// `PropertiesChanged`.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the signal cannot be sent.
+    pub async fn set_playback_status(&self, status: PlaybackStatus) -> MediaResult<()> {
+        self.script().set_status(status);
+        let player = self.interface().await?;
+        player
+            .get()
+            .await
+            .playback_status_changed(player.signal_context())
+            .await
+            .map_err(dbus_error("Failed to announce playback status"))
+    }
+
+    /// Changes the commands the player accepts and announces them with
+    /// `PropertiesChanged`.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the signal cannot be sent.
+    pub async fn set_capabilities(&self, capabilities: Capabilities) -> MediaResult<()> {
+        self.script().capabilities = capabilities;
+        let player = self.interface().await?;
+        let context = player.signal_context();
+        let interface = player.get().await;
+        let results = [
+            interface.can_play_changed(context).await,
+            interface.can_pause_changed(context).await,
+            interface.can_seek_changed(context).await,
+            interface.can_go_next_changed(context).await,
+            interface.can_go_previous_changed(context).await,
+            interface.can_control_changed(context).await,
+        ];
+        results
+            .into_iter()
+            .collect::<zbus::Result<Vec<()>>>()
+            .map(drop)
+            .map_err(dbus_error("Failed to announce capabilities"))
+    }
+
+    /// Moves the position, as if the user seeked in the player, and emits
+    /// `Seeked`.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the signal cannot be sent.
+    pub async fn seeked(&self, position: Duration) -> MediaResult<()> {
+        let player = self.interface().await?;
+        player
+            .get()
+            .await
+            .move_to(player.signal_context(), position)
+            .await
+            .map_err(|e| MediaError::DBusError(format!("Failed to announce seek: {e}")))
+    }
+
+    /// Removes the player from the bus, as if it quit.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`MediaError::DBusError`] if the name cannot be released.
+    pub async fn quit(self) -> MediaResult<()> {
+        self.connection
+            .release_name(self.bus_name.as_str())
+            .await
+            .map(drop)
+            .map_err(dbus_error("Failed to release the player name"))
+    }
+
+    fn script(&self) -> MutexGuard<'_, Script> {
+        lock(&self.script)
+    }
+
+    /// Returns the player interface as served on the bus.
+    async fn interface(&self) -> MediaResult<InterfaceRef<PlayerInterface>> {
+        self.connection
+            .object_server()
+            .interface::<_, PlayerInterface>(MPRIS_PATH)
+            .await
+            .map_err(dbus_error("Mock player interface not found"))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_script_position() {
+        let mut script = Script::new(MediaInfo {
+            duration: Some(Duration::from_secs(60)),
+            position: Some(Duration::from_secs(5)),
+            playback_status: PlaybackStatus::Paused,
+            ..MediaInfo::default()
+        });
+        assert_eq!(script.position(), Duration::from_secs(5));
+
+        script.set_position(Duration::from_secs(90));
+        assert_eq!(script.position(), Duration::from_secs(60));
+
+        script.set_status(PlaybackStatus::Stopped);
+        assert_eq!(script.position(), Duration::ZERO);
+    }
+
+    #[test]
+    fn test_script_metadata() {
+        let script = Script::new(MediaInfo {
+            title: Some("Song".into()),
+            artist: Some("Artist".into()),
+            duration: Some(Duration::from_secs(200)),
+            year: Some(1999),
+            ..MediaInfo::default()
+        });
+
+        let metadata = script.metadata();
+        assert_eq!(metadata.len(), 5);
+        assert_eq!(script.track_id(), "/org/mpris/MediaPlayer2/Track/1");
+        for key in [
+            "mpris:trackid",
+            "xesam:title",
+            "xesam:artist",
+            "mpris:length",
+            "xesam:contentCreated",
+        ] {
+            assert!(metadata.contains_key(key), "missing {key}");
+        }
+    }
+}
@@ -6,13 +6,16 @@
 //!
 //! # Architecture
 //!
-//! The backend system uses dynamic dispatch to select the appropriate
-//! implementation at runtime based on the target OS:
+//! The backend system selects the appropriate implementation at runtime
+//! based on the target OS, behind the type-erased [`DynBackend`]:
 //!
 //! - **Windows:** `windows_backend::WindowsBackend` using `WinRT`
 //! - **macOS:** `macos_backend::MacOSBackend` using `MediaRemote` framework
 //! - **Linux:** `linux_backend::LinuxBackend` using D-Bus/MPRIS
 //!
+//! A concrete backend type can also be used directly, with static
+//! dispatch; see [`MediaSessionsBuilder::build_with`](crate::MediaSessionsBuilder::build_with).
+//!
 //! # Safety
 //!
 //! All unsafe code is isolated within these backend modules. The public
@@ -30,9 +33,20 @@ pub mod macos_backend;
 #[cfg_attr(docsrs, doc(cfg(target_os = "linux")))]
 pub mod linux_backend;
 
+#[cfg(target_os = "linux")]
+mod linux_artwork;
+
+#[cfg(all(target_os = "linux", feature = "mock-mpris"))]
+#[cfg_attr(docsrs, doc(cfg(all(target_os = "linux", feature = "mock-mpris"))))]
+pub mod mock_mpris;
+
 pub mod backend;
+pub mod events;
+pub mod mock;
 
-pub use backend::{MediaSessionBackend, create_backend};
+pub use backend::{DynBackend, MediaSessionBackend, create_backend, create_backend_async};
+pub use events::{EventSink, RawUpdate};
+pub use mock::MockBackend;
 
 /// Get the list of available platform backends.
 ///
@@ -8,37 +8,45 @@
 //!
 //! - Windows 10 version 1803 or later
 
-use std::sync::Arc;
+use std::sync::{Arc, Mutex};
 use std::time::Duration;
 
-use tokio::sync::{RwLock, mpsc};
-use tokio::task::spawn_blocking;
+use tokio::runtime::Handle;
+use tokio::sync::RwLock;
 use windows::{
-    Foundation::TimeSpan,
+    Foundation::{TimeSpan, TypedEventHandler},
     Media::Control::{
-        GlobalSystemMediaTransportControlsSession,
+        CurrentSessionChangedEventArgs, GlobalSystemMediaTransportControlsSession,
         GlobalSystemMediaTransportControlsSessionManager,
         GlobalSystemMediaTransportControlsSessionPlaybackInfo,
         GlobalSystemMediaTransportControlsSessionPlaybackStatus,
         GlobalSystemMediaTransportControlsSessionTimelineProperties,
+        MediaPropertiesChangedEventArgs, PlaybackInfoChangedEventArgs, SessionsChangedEventArgs,
+        TimelinePropertiesChangedEventArgs,
     },
 };
 
 use super::backend::MediaSessionBackend;
+use super::events::{EventSink, RawUpdate};
 use crate::error::{MediaError, MediaResult};
 use crate::media_info::{MediaInfo, PlaybackStatus};
-use crate::media_sessions::{MediaSessionEvent, RepeatMode};
+use crate::media_sessions::RepeatMode;
 
 /// Windows Media Control backend.
 #[derive(Clone, Debug)]
 pub struct WindowsBackend {
     manager: Arc<RwLock<Option<GlobalSystemMediaTransportControlsSessionManager>>>,
     session: Arc<RwLock<Option<GlobalSystemMediaTransportControlsSession>>>,
+    /// Name reported by `get_active_app`, shared instead of reallocated.
+    app_name: Arc<str>,
+    runtime: Handle,
 }
 
 impl WindowsBackend {
     /// Creates a new Windows backend instance.
-    pub fn new() -> MediaResult<Self> {
+    ///
+    /// Blocking WinRT calls and event handler cleanup run on `runtime`.
+    pub fn new(runtime: Handle) -> MediaResult<Self> {
         let request_result = GlobalSystemMediaTransportControlsSessionManager::RequestAsync();
 
         match request_result {
@@ -46,6 +54,8 @@ impl WindowsBackend {
                 Ok(manager) => Ok(Self {
                     manager: Arc::new(RwLock::new(Some(manager))),
                     session: Arc::new(RwLock::new(None)),
+                    app_name: Arc::from("Windows Media Session"),
+                    runtime,
                 }),
                 Err(e) => Err(MediaError::Backend {
                     platform: "windows".to_string(),
@@ -139,7 +149,7 @@ impl WindowsBackend {
             if string.is_empty() {
                 None
             } else {
-                Some(string)
+                Some(string.into())
             }
         });
 
@@ -148,7 +158,7 @@ impl WindowsBackend {
             if string.is_empty() {
                 None
             } else {
-                Some(string)
+                Some(string.into())
             }
         });
 
@@ -157,7 +167,7 @@ impl WindowsBackend {
             if string.is_empty() {
                 None
             } else {
-                Some(string)
+                Some(string.into())
             }
         });
 
@@ -215,101 +225,178 @@ impl WindowsBackend {
             media_type: None,
         })
     }
+}
 
-    /// Polls for media session changes and emits events.
-    async fn poll_events(
-        &self,
-        tx: mpsc::Sender<MediaResult<MediaSessionEvent>>,
-        debounce_duration: Duration,
-    ) {
-        let mut last_status: Option<PlaybackStatus> = None;
-        let mut last_title: Option<String> = None;
-        let mut last_position: Option<Duration> = None;
-        let mut last_emit_time = tokio::time::Instant::now();
-
-        loop {
-            tokio::time::sleep(Duration::from_millis(250)).await;
-
-            // Check if channel is still open
-            if tx.is_closed() {
-                break;
-            }
+/// Removal callbacks for registered WinRT event handlers.
+#[derive(Default)]
+struct Registrations(Vec<Box<dyn FnOnce() + Send>>);
 
-            let info = match self.get_current().await {
-                Ok(Some(i)) => i,
-                Ok(None) => {
-                    if last_status.is_some() {
-                        last_status = None;
-                        let _ = tx.send(Ok(MediaSessionEvent::SessionClosed)).await;
-                    }
-                    continue;
-                }
-                Err(e) => {
-                    let _ = tx.send(Err(e)).await;
-                    continue;
-                }
-            };
-
-            // Debounce check
-            let now = tokio::time::Instant::now();
-            if now.duration_since(last_emit_time) < debounce_duration {
-                continue;
-            }
+impl Registrations {
+    /// Remembers how to remove one handler.
+    fn push(&mut self, remove: impl FnOnce() + Send + 'static) {
+        self.0.push(Box::new(remove));
+    }
 
-            // Check for session opened
-            if last_status.is_none() {
-                let _ = tx
-                    .send(Ok(MediaSessionEvent::SessionOpened {
-                        app_name: "Windows Media Session".to_string(),
-                    }))
-                    .await;
-            }
+    /// Removes all handlers.
+    fn remove_all(&mut self) {
+        for remove in self.0.drain(..) {
+            remove();
+        }
+    }
+}
 
-            // Check for metadata changes
-            let title_changed = info.title != last_title;
-            if title_changed {
-                last_title = info.title.clone();
-                let _ = tx
-                    .send(Ok(MediaSessionEvent::MetadataChanged(info.clone())))
-                    .await;
-                last_emit_time = now;
-                continue;
-            }
+/// SMTC change notifications feeding one [`EventSink`].
+///
+/// Handlers only push [`RawUpdate::Invalidated`]; the pipeline then
+/// re-reads the session through the guarded call path. Session handlers
+/// are moved to the new session whenever the manager reports a change.
+struct SmtcSubscription {
+    backend: WindowsBackend,
+    sink: EventSink,
+    manager_handlers: Mutex<Registrations>,
+    session_handlers: Mutex<Registrations>,
+}
 
-            // Check for playback status changes
-            if Some(info.playback_status) != last_status {
-                last_status = Some(info.playback_status);
-                let _ = tx
-                    .send(Ok(MediaSessionEvent::PlaybackStatusChanged(
-                        info.playback_status,
-                    )))
-                    .await;
-                last_emit_time = now;
-                continue;
+impl SmtcSubscription {
+    /// Registers handlers on the session manager and the current session.
+    fn start(backend: WindowsBackend, sink: EventSink) -> MediaResult<Arc<Self>> {
+        let manager = backend
+            .manager
+            .try_read()
+            .ok()
+            .and_then(|guard| guard.clone())
+            .ok_or_else(|| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: "Session manager not initialized".to_string(),
+            })?;
+
+        let subscription = Arc::new(Self {
+            backend,
+            sink,
+            manager_handlers: Mutex::new(Registrations::default()),
+            session_handlers: Mutex::new(Registrations::default()),
+        });
+
+        let weak = Arc::downgrade(&subscription);
+        let on_sessions_changed = move || {
+            if let Some(subscription) = weak.upgrade() {
+                subscription.bind_session();
+                let _ = subscription.sink.push(RawUpdate::Invalidated);
             }
+        };
 
-            // Check for position changes
-            if let Some(pos) = info.position {
-                let should_emit = last_position.map_or(true, |lp| {
-                    (pos.as_secs() as i64 - lp.as_secs() as i64).abs() > 1
-                });
-                if should_emit {
-                    let old_position = last_position;
-                    last_position = Some(pos);
-                    let _ = tx
-                        .send(Ok(MediaSessionEvent::PositionChanged {
-                            position: pos,
-                            old_position,
-                        }))
-                        .await;
-                    last_emit_time = now;
-                }
+        let mut handlers = Registrations::default();
+        let handler = TypedEventHandler::<
+            GlobalSystemMediaTransportControlsSessionManager,
+            CurrentSessionChangedEventArgs,
+        >::new({
+            let on_sessions_changed = on_sessions_changed.clone();
+            move |_, _| {
+                on_sessions_changed();
+                Ok(())
             }
+        });
+        let token = manager
+            .CurrentSessionChanged(&handler)
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("CurrentSessionChanged failed: {e:?}"),
+            })?;
+        let owner = manager.clone();
+        handlers.push(move || {
+            let _ = owner.RemoveCurrentSessionChanged(token);
+        });
+
+        let handler = TypedEventHandler::<
+            GlobalSystemMediaTransportControlsSessionManager,
+            SessionsChangedEventArgs,
+        >::new(move |_, _| {
+            on_sessions_changed();
+            Ok(())
+        });
+        let token = manager
+            .SessionsChanged(&handler)
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("SessionsChanged failed: {e:?}"),
+            })?;
+        handlers.push(move || {
+            let _ = manager.RemoveSessionsChanged(token);
+        });
+
+        *lock(&subscription.manager_handlers) = handlers;
+        subscription.bind_session();
+        Ok(subscription)
+    }
+
+    /// Moves the session handlers to the current session.
+    fn bind_session(&self) {
+        let mut handlers = lock(&self.session_handlers);
+        handlers.remove_all();
+
+        let Ok(Some(session)) = self.backend.get_session_blocking() else {
+            return;
+        };
+
+        let sink = self.sink.clone();
+        let handler = TypedEventHandler::<
+            GlobalSystemMediaTransportControlsSession,
+            MediaPropertiesChangedEventArgs,
+        >::new(move |_, _| {
+            sink.push(RawUpdate::Invalidated);
+            Ok(())
+        });
+        if let Ok(token) = session.MediaPropertiesChanged(&handler) {
+            let owner = session.clone();
+            handlers.push(move || {
+                let _ = owner.RemoveMediaPropertiesChanged(token);
+            });
+        }
+
+        let sink = self.sink.clone();
+        let handler = TypedEventHandler::<
+            GlobalSystemMediaTransportControlsSession,
+            PlaybackInfoChangedEventArgs,
+        >::new(move |_, _| {
+            sink.push(RawUpdate::Invalidated);
+            Ok(())
+        });
+        if let Ok(token) = session.PlaybackInfoChanged(&handler) {
+            let owner = session.clone();
+            handlers.push(move || {
+                let _ = owner.RemovePlaybackInfoChanged(token);
+            });
+        }
+
+        let sink = self.sink.clone();
+        let handler = TypedEventHandler::<
+            GlobalSystemMediaTransportControlsSession,
+            TimelinePropertiesChangedEventArgs,
+        >::new(move |_, _| {
+            sink.push(RawUpdate::Invalidated);
+            Ok(())
+        });
+        if let Ok(token) = session.TimelinePropertiesChanged(&handler) {
+            handlers.push(move || {
+                let _ = session.RemoveTimelinePropertiesChanged(token);
+            });
         }
     }
+
+    /// Removes all handlers.
+    fn stop(&self) {
+        lock(&self.manager_handlers).remove_all();
+        lock(&self.session_handlers).remove_all();
+    }
+}
+
+/// Locks a registration list, ignoring poisoning.
+fn lock(registrations: &Mutex<Registrations>) -> std::sync::MutexGuard<'_, Registrations> {
+    registrations
+        .lock()
+        .unwrap_or_else(std::sync::PoisonError::into_inner)
 }
 
-#[async_trait::async_trait]
 impl MediaSessionBackend for WindowsBackend {
     fn platform_name(&self) -> &'static str {
         "windows"
@@ -317,199 +404,246 @@ impl MediaSessionBackend for WindowsBackend {
 
     async fn get_current(&self) -> MediaResult<Option<MediaInfo>> {
         let this = self.clone();
-        spawn_blocking(move || match this.get_session_blocking()? {
-            Some(session) => Ok(Some(Self::extract_info(&session)?)),
-            None => Ok(None),
-        })
-        .await
-        .map_err(|e| MediaError::Backend {
-            platform: "windows".to_string(),
-            message: format!("spawn_blocking failed: {e:?}"),
-        })?
+        self.runtime
+            .spawn_blocking(move || match this.get_session_blocking()? {
+                Some(session) => Ok(Some(Self::extract_info(&session)?)),
+                None => Ok(None),
+            })
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })?
     }
 
-    async fn get_artwork(&self) -> MediaResult<Option<Vec<u8>>> {
+    async fn get_artwork(&self) -> MediaResult<Option<Arc<[u8]>>> {
         // Artwork not directly available via WinRT SMTC API
         Ok(None)
     }
 
-    fn get_active_app(&self) -> MediaResult<Option<String>> {
-        Ok(Some("Windows Media Session".to_string()))
+    fn get_active_app(&self) -> MediaResult<Option<Arc<str>>> {
+        Ok(Some(Arc::clone(&self.app_name)))
     }
 
     async fn play(&self) -> MediaResult<()> {
         let this = self.clone();
-        spawn_blocking(move || {
-            let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
-            session
-                .TryPlayAsync()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("Play failed: {e:?}"),
-                })?
-                .get()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("Play await failed: {e:?}"),
-                })?;
-            Ok(())
-        })
-        .await
-        .map_err(|e| MediaError::Backend {
-            platform: "windows".to_string(),
-            message: format!("spawn_blocking failed: {e:?}"),
-        })??;
+        self.runtime
+            .spawn_blocking(move || {
+                let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
+                session
+                    .TryPlayAsync()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("Play failed: {e:?}"),
+                    })?
+                    .get()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("Play await failed: {e:?}"),
+                    })?;
+                Ok(())
+            })
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })??;
         Ok(())
     }
 
     async fn pause(&self) -> MediaResult<()> {
         let this = self.clone();
-        spawn_blocking(move || {
-            let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
-            session
-                .TryPauseAsync()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("Pause failed: {e:?}"),
-                })?
-                .get()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("Pause await failed: {e:?}"),
-                })?;
-            Ok(())
-        })
-        .await
-        .map_err(|e| MediaError::Backend {
-            platform: "windows".to_string(),
-            message: format!("spawn_blocking failed: {e:?}"),
-        })??;
+        self.runtime
+            .spawn_blocking(move || {
+                let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
+                session
+                    .TryPauseAsync()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("Pause failed: {e:?}"),
+                    })?
+                    .get()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("Pause await failed: {e:?}"),
+                    })?;
+                Ok(())
+            })
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })??;
         Ok(())
     }
 
     async fn play_pause(&self) -> MediaResult<()> {
         let this = self.clone();
-        spawn_blocking(move || {
-            let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
-            session
-                .TryTogglePlayPauseAsync()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("TogglePlayPause failed: {e:?}"),
-                })?
-                .get()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("TogglePlayPause await failed: {e:?}"),
-                })?;
-            Ok(())
-        })
-        .await
-        .map_err(|e| MediaError::Backend {
-            platform: "windows".to_string(),
-            message: format!("spawn_blocking failed: {e:?}"),
-        })??;
+        self.runtime
+            .spawn_blocking(move || {
+                let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
+                session
+                    .TryTogglePlayPauseAsync()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("TogglePlayPause failed: {e:?}"),
+                    })?
+                    .get()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("TogglePlayPause await failed: {e:?}"),
+                    })?;
+                Ok(())
+            })
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })??;
         Ok(())
     }
 
     async fn stop(&self) -> MediaResult<()> {
         let this = self.clone();
-        spawn_blocking(move || {
-            let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
-            session
-                .TryStopAsync()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("Stop failed: {e:?}"),
-                })?
-                .get()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("Stop await failed: {e:?}"),
-                })?;
-            Ok(())
-        })
-        .await
-        .map_err(|e| MediaError::Backend {
-            platform: "windows".to_string(),
-            message: format!("spawn_blocking failed: {e:?}"),
-        })??;
+        self.runtime
+            .spawn_blocking(move || {
+                let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
+                session
+                    .TryStopAsync()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("Stop failed: {e:?}"),
+                    })?
+                    .get()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("Stop await failed: {e:?}"),
+                    })?;
+                Ok(())
+            })
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })??;
         Ok(())
     }
 
     async fn next(&self) -> MediaResult<()> {
         let this = self.clone();
-        spawn_blocking(move || {
-            let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
-            session
-                .TrySkipNextAsync()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("SkipNext failed: {e:?}"),
-                })?
-                .get()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("SkipNext await failed: {e:?}"),
-                })?;
-            Ok(())
-        })
-        .await
-        .map_err(|e| MediaError::Backend {
-            platform: "windows".to_string(),
-            message: format!("spawn_blocking failed: {e:?}"),
-        })??;
+        self.runtime
+            .spawn_blocking(move || {
+                let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
+                session
+                    .TrySkipNextAsync()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("SkipNext failed: {e:?}"),
+                    })?
+                    .get()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("SkipNext await failed: {e:?}"),
+                    })?;
+                Ok(())
+            })
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })??;
         Ok(())
     }
 
     async fn previous(&self) -> MediaResult<()> {
         let this = self.clone();
-        spawn_blocking(move || {
-            let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
-            session
-                .TrySkipPreviousAsync()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("SkipPrevious failed: {e:?}"),
-                })?
-                .get()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("SkipPrevious await failed: {e:?}"),
-                })?;
-            Ok(())
-        })
-        .await
-        .map_err(|e| MediaError::Backend {
-            platform: "windows".to_string(),
-            message: format!("spawn_blocking failed: {e:?}"),
-        })??;
+        self.runtime
+            .spawn_blocking(move || {
+                let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
+                session
+                    .TrySkipPreviousAsync()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("SkipPrevious failed: {e:?}"),
+                    })?
+                    .get()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("SkipPrevious await failed: {e:?}"),
+                    })?;
+                Ok(())
+            })
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })??;
         Ok(())
     }
 
     async fn seek(&self, position: Duration) -> MediaResult<()> {
         let this = self.clone();
         let ticks = (position.as_secs() * 10_000_000) as i64;
-        spawn_blocking(move || {
-            let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
-            session
-                .TryChangePlaybackPositionAsync(ticks)
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("Seek failed: {e:?}"),
-                })?
-                .get()
-                .map_err(|e| MediaError::Backend {
-                    platform: "windows".to_string(),
-                    message: format!("Seek await failed: {e:?}"),
-                })?;
-            Ok(())
-        })
-        .await
-        .map_err(|e| MediaError::Backend {
-            platform: "windows".to_string(),
-            message: format!("spawn_blocking failed: {e:?}"),
-        })??;
+        self.runtime
+            .spawn_blocking(move || {
+                let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
+                session
+                    .TryChangePlaybackPositionAsync(ticks)
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("Seek failed: {e:?}"),
+                    })?
+                    .get()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("Seek await failed: {e:?}"),
+                    })?;
+                Ok(())
+            })
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })??;
+        Ok(())
+    }
+
+    async fn seek_by(&self, offset_ms: i64) -> MediaResult<()> {
+        let this = self.clone();
+        self.runtime
+            .spawn_blocking(move || {
+                let session = this.get_session_blocking()?.ok_or(MediaError::NoSession)?;
+                // The timeline is a snapshot held by the session, so reading
+                // it does not go to the player.
+                let position = session
+                    .GetTimelineProperties()
+                    .and_then(|timeline| timeline.Position())
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("GetTimelineProperties failed: {e:?}"),
+                    })?;
+                let ticks = position
+                    .Duration
+                    .saturating_add(offset_ms.saturating_mul(10_000))
+                    .max(0);
+                session
+                    .TryChangePlaybackPositionAsync(ticks)
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("Seek failed: {e:?}"),
+                    })?
+                    .get()
+                    .map_err(|e| MediaError::Backend {
+                        platform: "windows".to_string(),
+                        message: format!("Seek await failed: {e:?}"),
+                    })?;
+                Ok(())
+            })
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })??;
         Ok(())
     }
 
@@ -534,14 +668,21 @@ impl MediaSessionBackend for WindowsBackend {
         })
     }
 
-    async fn start_listening(
-        &self,
-        tx: mpsc::Sender<MediaResult<MediaSessionEvent>>,
-        debounce_duration: Duration,
-    ) -> MediaResult<()> {
+    async fn subscribe(&self, sink: EventSink) -> MediaResult<()> {
         let this = self.clone();
-        tokio::spawn(async move {
-            this.poll_events(tx, debounce_duration).await;
+        let subscription = self
+            .runtime
+            .spawn_blocking(move || SmtcSubscription::start(this, sink))
+            .await
+            .map_err(|e| MediaError::Backend {
+                platform: "windows".to_string(),
+                message: format!("spawn_blocking failed: {e:?}"),
+            })??;
+
+        // Handlers stay registered until the pipeline goes away.
+        self.runtime.spawn(async move {
+            subscription.sink.closed().await;
+            subscription.stop();
         });
         Ok(())
     }
@@ -552,17 +693,20 @@ mod tests {
     use super::*;
 
     #[test]
-    #[ignore]
+    #[ignore = "needs a desktop session"]
     fn test_backend_creation() {
-        let result = WindowsBackend::new();
-        println!("Windows backend: {result:?}");
+        let rt = tokio::runtime::Runtime::new().unwrap();
+        assert!(WindowsBackend::new(rt.handle().clone()).is_ok());
     }
 
     #[test]
     fn test_platform_name() {
+        let rt = tokio::runtime::Runtime::new().unwrap();
         let backend = WindowsBackend {
             manager: Arc::new(RwLock::new(None)),
             session: Arc::new(RwLock::new(None)),
+            app_name: Arc::from("Windows Media Session"),
+            runtime: rt.handle().clone(),
         };
         assert_eq!(backend.platform_name(), "windows");
     }
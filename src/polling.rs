@@ -0,0 +1,282 @@
+//! Adaptive poll scheduling for backends without change notifications.
+//!
+//! The poll interval follows what the session is doing:
+//!
+//! - **After a command:** polls quickly for a short while, so the result
+//!   of `play()`, `next()` and friends shows up at once.
+//! - **Playing:** polls at a steady rate to keep the position current.
+//! - **Paused or no session:** starts at the configured interval and
+//!   doubles it on every poll that sees no change, while it stays within
+//!   a cap. Any change resets it.
+//!
+//! Outside of command boosts, wakeups are aligned to a wall-clock grid of
+//! the current interval. All instances on the machine, in this process or
+//! another, then wake together instead of spreading wakeups over time.
+//! Because backoff intervals are the base times a power of two, never the
+//! cap itself, instances at different backoff levels still share grid
+//! points.
+
+use std::time::{Duration, SystemTime, UNIX_EPOCH};
+
+use tokio::time::Instant;
+
+use crate::media_info::{MediaInfo, PlaybackStatus};
+
+/// Lower bound for every interval, guarding against busy loops.
+const MIN_INTERVAL: Duration = Duration::from_millis(10);
+
+/// Poll intervals for each session state.
+///
+/// # Examples
+///
+/// ```rust
+/// use media_sessions::{MediaSessions, PollConfig};
+/// use std::time::Duration;
+///
+/// let builder = MediaSessions::builder().polling(PollConfig {
+///     playing: Duration::from_millis(250),
+///     max_idle: Duration::from_secs(10),
+///     ..PollConfig::default()
+/// });
+/// ```
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct PollConfig {
+    /// Interval while media is playing.
+    pub playing: Duration,
+    /// Initial interval while media is paused or stopped.
+    pub paused: Duration,
+    /// Initial interval while no session exists.
+    pub no_session: Duration,
+    /// Cap for the idle backoff.
+    ///
+    /// The interval stops doubling before it would exceed the cap, so it
+    /// settles at the largest power-of-two multiple of the base within it.
+    pub max_idle: Duration,
+    /// Interval right after a playback command.
+    pub after_command: Duration,
+    /// How long the fast interval lasts after a command.
+    pub command_boost: Duration,
+    /// Whether to align wakeups to a shared wall-clock grid.
+    pub align_wakeups: bool,
+}
+
+impl PollConfig {
+    /// Creates the default configuration.
+    ///
+    /// # Defaults
+    ///
+    /// - `playing`: 500ms
+    /// - `paused`: 1 second
+    /// - `no_session`: 2 seconds
+    /// - `max_idle`: 30 seconds, so paused polling settles at 16 seconds
+    /// - `after_command`: 100ms
+    /// - `command_boost`: 2 seconds
+    /// - `align_wakeups`: true
+    #[must_use]
+    pub const fn new() -> Self {
+        Self {
+            playing: Duration::from_millis(500),
+            paused: Duration::from_secs(1),
+            no_session: Duration::from_secs(2),
+            max_idle: Duration::from_secs(30),
+            after_command: Duration::from_millis(100),
+            command_boost: Duration::from_secs(2),
+            align_wakeups: true,
+        }
+    }
+}
+
+impl Default for PollConfig {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Session state as far as polling is concerned.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum PollState {
+    /// Media is playing, or about to.
+    Playing,
+    /// Media is paused or stopped.
+    Paused,
+    /// No session exists.
+    NoSession,
+}
+
+impl PollState {
+    /// Classifies the result of a poll.
+    #[must_use]
+    pub fn of(info: Option<&MediaInfo>) -> Self {
+        match info.map(|info| info.playback_status) {
+            None => Self::NoSession,
+            Some(PlaybackStatus::Playing | PlaybackStatus::Transitioning) => Self::Playing,
+            Some(PlaybackStatus::Paused | PlaybackStatus::Stopped) => Self::Paused,
+        }
+    }
+}
+
+/// Decides when to poll next.
+///
+/// # Examples
+///
+/// ```rust
+/// use media_sessions::polling::{PollConfig, PollScheduler, PollState};
+/// use tokio::time::Instant;
+///
+/// let mut scheduler = PollScheduler::new(PollConfig::default());
+/// scheduler.observe(PollState::NoSession, false);
+/// let next = scheduler.next_wakeup(Instant::now());
+/// ```
+#[derive(Debug, Clone)]
+pub struct PollScheduler {
+    config: PollConfig,
+    state: PollState,
+    idle_interval: Duration,
+    boost_until: Option<Instant>,
+}
+
+impl PollScheduler {
+    /// Creates a scheduler that assumes no session until told otherwise.
+    #[must_use]
+    pub const fn new(config: PollConfig) -> Self {
+        Self {
+            config,
+            state: PollState::NoSession,
+            idle_interval: config.no_session,
+            boost_until: None,
+        }
+    }
+
+    /// Records the result of a poll.
+    ///
+    /// `changed` tells whether the poll saw anything new; idle intervals
+    /// only grow while nothing changes.
+    pub fn observe(&mut self, state: PollState, changed: bool) {
+        if changed || state != self.state {
+            self.idle_interval = self.base_interval(state);
+        } else {
+            let doubled = self.idle_interval * 2;
+            if doubled <= self.config.max_idle {
+                self.idle_interval = doubled;
+            }
+        }
+        self.state = state;
+    }
+
+    /// Records a failed poll, which backs off like an unchanged one.
+    pub fn observe_failure(&mut self) {
+        self.observe(self.state, false);
+    }
+
+    /// Switches to the fast interval after a playback command.
+    pub fn on_command(&mut self, now: Instant) {
+        self.boost_until = Some(now + self.config.command_boost);
+    }
+
+    /// Returns the current interval.
+    #[must_use]
+    pub fn interval(&self, now: Instant) -> Duration {
+        let interval = if self.boost_until.is_some_and(|until| now < until) {
+            self.config.after_command
+        } else if self.state == PollState::Playing {
+            self.config.playing
+        } else {
+            self.idle_interval
+        };
+        interval.max(MIN_INTERVAL)
+    }
+
+    /// Returns when to poll next.
+    #[must_use]
+    pub fn next_wakeup(&self, now: Instant) -> Instant {
+        let wall = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .unwrap_or_default();
+        self.next_wakeup_at(now, wall)
+    }
+
+    /// [`next_wakeup`](Self::next_wakeup) with an explicit wall-clock time,
+    /// given as time since the Unix epoch.
+    fn next_wakeup_at(&self, now: Instant, wall: Duration) -> Instant {
+        let interval = self.interval(now);
+        let boosted = self.boost_until.is_some_and(|until| now < until);
+        if !self.config.align_wakeups || boosted {
+            return now + interval;
+        }
+
+        let interval_nanos = interval.as_nanos();
+        let offset = wall.as_nanos() % interval_nanos;
+        let wait = interval_nanos - offset;
+        // `wait` is at most `interval`, which fits in a u64 of nanoseconds
+        // for any realistic configuration.
+        now + Duration::from_nanos(u64::try_from(wait).unwrap_or(u64::MAX))
+    }
+
+    const fn base_interval(&self, state: PollState) -> Duration {
+        match state {
+            PollState::Playing => self.config.playing,
+            PollState::Paused => self.config.paused,
+            PollState::NoSession => self.config.no_session,
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_idle_backoff_is_capped_and_reset() {
+        let mut scheduler = PollScheduler::new(PollConfig::new());
+        let now = Instant::now();
+
+        scheduler.observe(PollState::NoSession, false);
+        assert_eq!(scheduler.interval(now), Duration::from_secs(4));
+        for _ in 0..10 {
+            scheduler.observe(PollState::NoSession, false);
+        }
+        // 2 s doubled within 30 s: 16 s, which shares the grid of 2 s.
+        assert_eq!(scheduler.interval(now), Duration::from_secs(16));
+
+        scheduler.observe(PollState::Paused, true);
+        assert_eq!(scheduler.interval(now), Duration::from_secs(1));
+    }
+
+    #[test]
+    fn test_playing_does_not_back_off() {
+        let mut scheduler = PollScheduler::new(PollConfig::new());
+        let now = Instant::now();
+
+        for _ in 0..5 {
+            scheduler.observe(PollState::Playing, false);
+        }
+        assert_eq!(scheduler.interval(now), Duration::from_millis(500));
+    }
+
+    #[test]
+    fn test_command_boost_expires() {
+        let mut scheduler = PollScheduler::new(PollConfig::new());
+        let now = Instant::now();
+
+        scheduler.on_command(now);
+        assert_eq!(scheduler.interval(now), Duration::from_millis(100));
+        assert_eq!(
+            scheduler.next_wakeup_at(now, Duration::from_millis(1_234)),
+            now + Duration::from_millis(100)
+        );
+        assert_eq!(
+            scheduler.interval(now + Duration::from_secs(3)),
+            Duration::from_secs(2)
+        );
+    }
+
+    #[test]
+    fn test_wakeups_align_to_grid() {
+        let scheduler = PollScheduler::new(PollConfig::new());
+        let now = Instant::now();
+
+        // Two seconds without a session: the next grid point is at 10s.
+        let wakeup = scheduler.next_wakeup_at(now, Duration::from_millis(8_500));
+        assert_eq!(wakeup, now + Duration::from_millis(1_500));
+    }
+}
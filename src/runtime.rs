@@ -0,0 +1,92 @@
+//! Tokio runtime selection for background work.
+//!
+//! `MediaSessions` never creates nested runtimes. Every background task
+//! (event listeners, blocking `WinRT` calls) is spawned on a single
+//! [`Handle`] chosen once at construction time:
+//!
+//! 1. The handle passed to [`MediaSessionsBuilder::runtime`], if any.
+//! 2. Otherwise, the runtime the constructor is called from.
+//! 3. Otherwise, a small process-wide fallback runtime that is created
+//!    lazily on first use and shared by all instances.
+//!
+//! [`MediaSessionsBuilder::runtime`]: crate::MediaSessionsBuilder::runtime
+
+use std::sync::OnceLock;
+
+use tokio::runtime::{Builder, Handle, Runtime};
+
+use crate::error::{MediaError, MediaResult};
+
+/// Worker threads of the fallback runtime.
+///
+/// Backends only run light I/O-bound tasks, so a single worker is enough.
+const FALLBACK_WORKER_THREADS: usize = 1;
+
+/// Process-wide fallback runtime, used only when no runtime is available.
+static FALLBACK_RUNTIME: OnceLock<Runtime> = OnceLock::new();
+
+/// Resolves the runtime handle used for all internal spawns.
+///
+/// # Errors
+///
+/// Returns [`MediaError::Backend`] if the fallback runtime cannot be created.
+pub fn resolve(explicit: Option<Handle>) -> MediaResult<Handle> {
+    if let Some(handle) = explicit {
+        return Ok(handle);
+    }
+
+    if let Ok(handle) = Handle::try_current() {
+        return Ok(handle);
+    }
+
+    fallback().map(|rt| rt.handle().clone())
+}
+
+/// Returns the lazily created fallback runtime.
+fn fallback() -> MediaResult<&'static Runtime> {
+    if let Some(rt) = FALLBACK_RUNTIME.get() {
+        return Ok(rt);
+    }
+
+    let rt = Builder::new_multi_thread()
+        .worker_threads(FALLBACK_WORKER_THREADS)
+        .thread_name("media-sessions")
+        .enable_all()
+        .build()
+        .map_err(|e| MediaError::Backend {
+            platform: std::env::consts::OS.to_string(),
+            message: format!("Failed to create runtime: {e}"),
+        })?;
+
+    // A concurrent caller may have won the race; the spare runtime is
+    // dropped here, outside of any async context.
+    Ok(FALLBACK_RUNTIME.get_or_init(|| rt))
+}
+
+#[cfg(test)]
+mod tests {
+    use tokio::runtime::RuntimeFlavor;
+
+    use super::*;
+
+    #[test]
+    fn test_resolve_prefers_explicit_handle() {
+        let rt = Builder::new_current_thread().enable_all().build().unwrap();
+        let handle = resolve(Some(rt.handle().clone())).unwrap();
+        assert_eq!(handle.runtime_flavor(), RuntimeFlavor::CurrentThread);
+    }
+
+    #[test]
+    fn test_resolve_uses_current_runtime() {
+        let rt = Builder::new_current_thread().enable_all().build().unwrap();
+        let flavor = rt.block_on(async { resolve(None).unwrap().runtime_flavor() });
+        assert_eq!(flavor, RuntimeFlavor::CurrentThread);
+    }
+
+    #[test]
+    fn test_resolve_falls_back_outside_runtime() {
+        let handle = resolve(None).unwrap();
+        assert_eq!(handle.runtime_flavor(), RuntimeFlavor::MultiThread);
+        assert!(FALLBACK_RUNTIME.get().is_some());
+    }
+}
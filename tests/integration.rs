@@ -6,6 +6,10 @@
 //! ```bash
 //! cargo test --test integration -- --ignored
 //! ```
+//!
+//! Tests against `MockBackend` always run. On Linux with the `linux`
+//! feature, the `mpris` tests run the real backend against fake players on
+//! a private `dbus-daemon`.
 
 use std::time::Duration;
 
@@ -98,8 +102,6 @@ async fn test_shuffle_control() {
 #[tokio::test]
 #[ignore]
 async fn test_event_stream() {
-    use futures::StreamExt;
-
     let sessions = MediaSessions::new().expect("Failed to create MediaSessions");
     let stream_result = sessions.watch().await;
 
@@ -157,3 +159,552 @@ fn test_available_platforms() {
         platforms
     );
 }
+
+/// Builds a `MockBackend` with a playing track.
+fn mock_player() -> media_sessions::platform::MockBackend {
+    media_sessions::platform::MockBackend::new().session(
+        "mock-player",
+        media_sessions::MediaInfo {
+            title: Some("Track".into()),
+            artist: Some("Artist".into()),
+            position: Some(Duration::from_secs(5)),
+            ..Default::default()
+        },
+    )
+}
+
+/// Tests querying and controlling a mocked player.
+#[tokio::test]
+async fn test_mock_backend_current_and_controls() {
+    use media_sessions::platform::mock::MockMethod;
+
+    let mock = mock_player().artwork(vec![1, 2, 3]);
+    let sessions = MediaSessions::builder()
+        .backend(mock.clone())
+        .build()
+        .expect("Failed to build MediaSessions");
+
+    let info = sessions.current().await.unwrap().unwrap();
+    assert_eq!(info.display_string(), "Artist - Track");
+    let artwork = info.artwork.unwrap();
+    assert_eq!(artwork, media_sessions::ArtworkId::of(&[1, 2, 3]));
+    assert_eq!(
+        sessions.artwork(artwork).await.unwrap().as_deref(),
+        Some(&[1, 2, 3][..])
+    );
+
+    sessions.pause().await.unwrap();
+    let info = sessions.current().await.unwrap().unwrap();
+    assert_eq!(info.playback_status, PlaybackStatus::Paused);
+
+    assert_eq!(mock.calls(MockMethod::GetCurrent), 2);
+    assert_eq!(mock.calls(MockMethod::Pause), 1);
+    assert_eq!(
+        sessions.active_app().await.unwrap().as_deref(),
+        Some("mock-player")
+    );
+}
+
+/// Tests that commands the player does not accept fail without retries.
+#[tokio::test]
+async fn test_mock_backend_capabilities() {
+    use media_sessions::Capabilities;
+    use media_sessions::platform::mock::MockMethod;
+
+    let capabilities = Capabilities {
+        can_seek: false,
+        ..Capabilities::default()
+    };
+    let mock = mock_player().capabilities(capabilities);
+    let sessions = MediaSessions::builder()
+        .backend(mock.clone())
+        .build()
+        .expect("Failed to build MediaSessions");
+
+    assert_eq!(sessions.capabilities().await.unwrap(), Some(capabilities));
+    assert!(matches!(
+        sessions.seek(Duration::from_secs(10)).await,
+        Err(media_sessions::MediaError::NotSupported(_))
+    ));
+    assert_eq!(mock.calls(MockMethod::Seek), 1);
+    sessions.next().await.unwrap();
+}
+
+/// Tests relative seeks on a backend without native support for them.
+#[tokio::test]
+async fn test_mock_backend_seek_by() {
+    let sessions = MediaSessions::builder()
+        .backend(mock_player())
+        .build()
+        .expect("Failed to build MediaSessions");
+
+    sessions.seek_by(10_500).await.unwrap();
+    let info = sessions.current().await.unwrap().unwrap();
+    assert_eq!(info.position, Some(Duration::from_millis(15_500)));
+
+    // Seeking before the start stops at the start.
+    sessions.seek_by(-60_000).await.unwrap();
+    let info = sessions.current().await.unwrap().unwrap();
+    assert_eq!(info.position, Some(Duration::ZERO));
+}
+
+/// Tests that rapid seeks are combined into the latest position.
+#[tokio::test]
+async fn test_combine_writes() {
+    use media_sessions::platform::mock::MockMethod;
+
+    let mock = mock_player().latency(MockMethod::Seek, Duration::from_millis(50));
+    let sessions = MediaSessions::builder()
+        .backend(mock.clone())
+        .combine_writes(true)
+        .build()
+        .expect("Failed to build MediaSessions");
+
+    let seeks = (1..=10).map(|secs| sessions.seek(Duration::from_secs(secs)));
+    for result in futures::future::join_all(seeks).await {
+        result.unwrap();
+    }
+
+    // The first seek and the last one; the rest were superseded.
+    assert_eq!(mock.calls(MockMethod::Seek), 2);
+    assert_eq!(sessions.metrics().writes_combined, 8);
+    let info = sessions.current().await.unwrap().unwrap();
+    assert_eq!(info.position, Some(Duration::from_secs(10)));
+}
+
+/// Tests building from inside a single-threaded runtime.
+#[tokio::test(flavor = "current_thread")]
+async fn test_build_async() {
+    let sessions = MediaSessions::builder()
+        .backend(mock_player())
+        .build_async()
+        .await
+        .expect("Failed to build MediaSessions");
+
+    let info = sessions.current().await.unwrap().unwrap();
+    assert_eq!(info.display_string(), "Artist - Track");
+}
+
+/// Tests that artwork is scaled down to the configured size.
+#[tokio::test]
+async fn test_artwork_max_size() {
+    let cover = image::RgbImage::from_fn(640, 480, |x, y| image::Rgb([x as u8, y as u8, 0]));
+    let mut png = std::io::Cursor::new(Vec::new());
+    image::DynamicImage::from(cover)
+        .write_to(&mut png, image::ImageFormat::Png)
+        .unwrap();
+
+    let sessions = MediaSessions::builder()
+        .backend(mock_player().artwork(png.into_inner()))
+        .artwork_max_size(160, 160)
+        .build()
+        .expect("Failed to build MediaSessions");
+
+    for _ in 0..2 {
+        let info = sessions.current().await.unwrap().unwrap();
+        let bytes = sessions.artwork(info.artwork.unwrap()).await.unwrap();
+        let thumbnail = image::load_from_memory(&bytes.unwrap()).unwrap();
+        assert_eq!((thumbnail.width(), thumbnail.height()), (160, 120));
+    }
+}
+
+/// Tests that artwork dropped from the store is fetched again only while
+/// the player still shows it, and that unchanged artwork is not fetched.
+#[tokio::test]
+async fn test_artwork_store() {
+    use media_sessions::platform::mock::MockMethod;
+
+    let mock = mock_player().artwork(vec![1, 2, 3]);
+    let sessions = MediaSessions::builder()
+        .backend(mock.clone())
+        .build()
+        .expect("Failed to build MediaSessions");
+    let id = sessions.current().await.unwrap().unwrap().artwork.unwrap();
+    let calls = mock.calls(MockMethod::GetArtwork);
+    assert!(sessions.artwork(id).await.unwrap().is_some());
+    assert_eq!(mock.calls(MockMethod::GetArtwork), calls);
+
+    // Nothing fits in an empty store.
+    let sessions = MediaSessions::builder()
+        .backend(mock.clone())
+        .artwork_cache_size(0)
+        .build()
+        .expect("Failed to build MediaSessions");
+    let id = sessions.current().await.unwrap().unwrap().artwork.unwrap();
+    let calls = mock.calls(MockMethod::GetArtwork);
+    assert_eq!(
+        sessions.artwork(id).await.unwrap().as_deref(),
+        Some(&[1, 2, 3][..])
+    );
+    assert_eq!(mock.calls(MockMethod::GetArtwork), calls + 1);
+
+    // The player moved on to another cover.
+    let mock = mock.artwork(vec![4, 5, 6]);
+    assert_eq!(sessions.artwork(id).await.unwrap(), None);
+    assert_eq!(mock.calls(MockMethod::GetArtwork), calls + 2);
+    let info = sessions.current().await.unwrap().unwrap();
+    assert_eq!(
+        info.artwork,
+        Some(media_sessions::ArtworkId::of(&[4, 5, 6]))
+    );
+
+    // An unchanged cover is neither fetched nor hashed again.
+    let calls = mock.calls(MockMethod::GetArtwork);
+    let again = sessions.current().await.unwrap().unwrap();
+    assert_eq!(again.artwork, info.artwork);
+    assert_eq!(mock.calls(MockMethod::GetArtwork), calls);
+}
+
+/// Tests that a scripted timeline reaches the event stream.
+#[tokio::test]
+async fn test_mock_backend_timeline_events() {
+    use futures::StreamExt;
+    use media_sessions::MediaSessionEvent;
+
+    let paused = media_sessions::MediaInfo {
+        title: Some("Track".into()),
+        artist: Some("Artist".into()),
+        position: Some(Duration::from_secs(5)),
+        playback_status: PlaybackStatus::Paused,
+        ..Default::default()
+    };
+    let mock = mock_player().at(Duration::from_millis(50), Some(paused));
+    let sessions = MediaSessions::builder()
+        .backend(mock)
+        .debounce_duration(Duration::from_millis(10))
+        .build()
+        .expect("Failed to build MediaSessions");
+
+    let mut stream = sessions.watch().await.unwrap();
+    let mut events = Vec::new();
+    while let Ok(Some(event)) = tokio::time::timeout(Duration::from_secs(2), stream.next()).await {
+        let event = event.unwrap();
+        let done = event == MediaSessionEvent::PlaybackStatusChanged(PlaybackStatus::Paused);
+        events.push(event);
+        if done {
+            break;
+        }
+    }
+
+    assert_eq!(
+        events.first(),
+        Some(&MediaSessionEvent::SessionOpened {
+            app_name: "mock-player".to_string()
+        })
+    );
+    assert_eq!(
+        events.last(),
+        Some(&MediaSessionEvent::PlaybackStatusChanged(
+            PlaybackStatus::Paused
+        ))
+    );
+}
+
+/// Tests calling a mocked player through its concrete type.
+#[tokio::test]
+async fn test_mock_backend_static_dispatch() {
+    use media_sessions::platform::MockBackend;
+    use media_sessions::platform::mock::MockMethod;
+
+    let mock = mock_player();
+    let sessions: MediaSessions<MockBackend> = MediaSessions::builder()
+        .build_with(mock.clone())
+        .expect("Failed to build MediaSessions");
+
+    sessions.pause().await.unwrap();
+    let info = sessions.current().await.unwrap().unwrap();
+    assert_eq!(info.playback_status, media_sessions::PlaybackStatus::Paused);
+    assert_eq!(
+        sessions.active_app().await.unwrap().as_deref(),
+        Some("mock-player")
+    );
+    assert_eq!(mock.calls(MockMethod::Pause), 1);
+}
+
+/// Tests that a disabled circuit breaker also turns retries off.
+#[tokio::test]
+async fn test_mock_backend_disabled_breaker_does_not_retry() {
+    use media_sessions::CircuitBreakerConfig;
+    use media_sessions::platform::mock::{MockFailure, MockMethod};
+
+    let mock = mock_player().fail(MockMethod::Stop, MockFailure::Timeout);
+    let sessions = MediaSessions::builder()
+        .backend(mock.clone())
+        .circuit_breaker(CircuitBreakerConfig::disabled())
+        .build()
+        .expect("Failed to build MediaSessions");
+
+    assert!(sessions.stop().await.is_err());
+    assert_eq!(mock.calls(MockMethod::Stop), 1);
+    assert_eq!(sessions.metrics().retries, 0);
+}
+
+/// Tests that a hung player trips the circuit breaker.
+#[tokio::test]
+async fn test_mock_backend_failure_opens_circuit() {
+    use media_sessions::platform::mock::{MockFailure, MockMethod};
+
+    let mock = mock_player().fail(MockMethod::Stop, MockFailure::Timeout);
+    let sessions = MediaSessions::builder()
+        .backend(mock.clone())
+        .build()
+        .expect("Failed to build MediaSessions");
+
+    let mut circuit_open = false;
+    for _ in 0..10 {
+        if let Err(media_sessions::MediaError::CircuitOpen { .. }) = sessions.stop().await {
+            circuit_open = true;
+            break;
+        }
+    }
+
+    assert!(circuit_open, "circuit never opened");
+    let calls = mock.calls(MockMethod::Stop);
+    let _ = sessions.stop().await;
+    assert_eq!(
+        mock.calls(MockMethod::Stop),
+        calls,
+        "open circuit made a call"
+    );
+
+    let metrics = sessions.metrics();
+    assert_eq!(metrics.circuit_opens, 1);
+    assert!(metrics.rejected >= 1);
+    assert_eq!(
+        metrics.operation("stop").unwrap().timeouts,
+        metrics.timeouts
+    );
+}
+
+/// Tests that backend calls and events show up in the metrics.
+#[tokio::test]
+async fn test_mock_backend_metrics() {
+    use futures::StreamExt;
+    use media_sessions::platform::mock::MockMethod;
+
+    let mock = mock_player().latency(MockMethod::Play, Duration::from_millis(20));
+    let sessions = MediaSessions::builder()
+        .backend(mock.clone())
+        .build()
+        .expect("Failed to build MediaSessions");
+
+    sessions.play().await.unwrap();
+    let mut stream = sessions.watch().await.unwrap();
+    stream.next().await.unwrap().unwrap();
+
+    let metrics = sessions.metrics();
+    let play = metrics.operation("play").unwrap();
+    assert_eq!((play.calls, play.errors), (1, 0));
+    assert!(play.latency.p99() >= Duration::from_millis(20));
+    assert!(metrics.operation("get_current").unwrap().calls >= 1);
+    assert!(metrics.backend_calls >= 2);
+    assert!(metrics.events_emitted >= 1);
+}
+
+/// Tests that a backend without notifications is polled.
+#[tokio::test]
+async fn test_mock_backend_polling_fallback() {
+    use futures::StreamExt;
+    use media_sessions::{MediaSessionEvent, PollConfig};
+
+    let mock = mock_player().notifications(false);
+    let sessions = MediaSessions::builder()
+        .backend(mock.clone())
+        .debounce_duration(Duration::from_millis(10))
+        .polling(PollConfig {
+            playing: Duration::from_millis(20),
+            align_wakeups: false,
+            ..PollConfig::default()
+        })
+        .build()
+        .expect("Failed to build MediaSessions");
+
+    let mut stream = sessions.watch().await.unwrap();
+    let first = stream.next().await.unwrap().unwrap();
+    assert!(matches!(first, MediaSessionEvent::SessionOpened { .. }));
+
+    mock.set_state(None);
+    let closed = tokio::time::timeout(Duration::from_secs(2), async {
+        while let Some(event) = stream.next().await {
+            if event.unwrap() == MediaSessionEvent::SessionClosed {
+                return true;
+            }
+        }
+        false
+    })
+    .await;
+    assert_eq!(closed, Ok(true));
+}
+
+/// Tests of the Linux backend against fake MPRIS players on a private bus.
+///
+/// They need `dbus-daemon` and the `mock-mpris` feature, but no desktop
+/// session or media player.
+#[cfg(all(target_os = "linux", feature = "mock-mpris"))]
+mod mpris {
+    use std::time::Duration;
+
+    use futures::StreamExt;
+    use media_sessions::platform::linux_backend::LinuxBackend;
+    use media_sessions::platform::mock_mpris::{MockMprisPlayer, MockSessionBus};
+    use media_sessions::{
+        MediaInfo, MediaSessionEvent, MediaSessions, MediaSessionsBuilder, PlaybackStatus,
+        RepeatMode,
+    };
+    use tokio::runtime::Handle;
+
+    fn track(title: &str) -> MediaInfo {
+        MediaInfo {
+            title: Some(title.into()),
+            artist: Some("Artist".into()),
+            duration: Some(Duration::from_secs(200)),
+            position: Some(Duration::from_secs(5)),
+            playback_status: PlaybackStatus::Paused,
+            ..MediaInfo::default()
+        }
+    }
+
+    /// Starts a private bus with one paused player, and sessions on it.
+    async fn setup(
+        builder: MediaSessionsBuilder,
+    ) -> (MockSessionBus, MockMprisPlayer, MediaSessions<LinuxBackend>) {
+        let bus = MockSessionBus::start().expect("dbus-daemon must be installed");
+        let player = bus.spawn_player("fake", track("Track")).await.unwrap();
+        let backend = bus.backend(Handle::current()).await.unwrap();
+        let sessions = builder.build_with(backend).unwrap();
+        (bus, player, sessions)
+    }
+
+    /// Waits up to two seconds for an event matching `wanted`.
+    async fn next_matching(
+        stream: &mut (
+                 impl futures::Stream<Item = media_sessions::MediaResult<MediaSessionEvent>> + Unpin
+             ),
+        wanted: impl Fn(&MediaSessionEvent) -> bool,
+    ) -> MediaSessionEvent {
+        tokio::time::timeout(Duration::from_secs(2), async {
+            loop {
+                let event = stream.next().await.expect("stream ended").unwrap();
+                if wanted(&event) {
+                    return event;
+                }
+            }
+        })
+        .await
+        .expect("no matching event")
+    }
+
+    /// Tests reading the session of a player.
+    #[tokio::test]
+    async fn test_mpris_current() {
+        let (_bus, _player, sessions) = setup(MediaSessions::builder()).await;
+
+        let info = sessions.current().await.unwrap().unwrap();
+        assert_eq!(info.display_string(), "Artist - Track");
+        assert_eq!(info.duration, Some(Duration::from_secs(200)));
+        assert_eq!(info.position, Some(Duration::from_secs(5)));
+        assert_eq!(info.playback_status, PlaybackStatus::Paused);
+        assert_eq!(
+            sessions.active_app().await.unwrap().as_deref(),
+            Some("fake")
+        );
+    }
+
+    /// Tests that commands reach the player.
+    #[tokio::test]
+    async fn test_mpris_controls() {
+        let (_bus, player, sessions) = setup(MediaSessions::builder()).await;
+
+        sessions.play().await.unwrap();
+        assert_eq!(player.playback_status(), PlaybackStatus::Playing);
+        sessions.pause().await.unwrap();
+        assert_eq!(player.playback_status(), PlaybackStatus::Paused);
+
+        sessions.seek(Duration::from_secs(30)).await.unwrap();
+        assert_eq!(player.position(), Duration::from_secs(30));
+        assert_eq!(player.calls("SetPosition"), 1);
+        sessions.seek_by(-10_000).await.unwrap();
+        assert_eq!(player.position(), Duration::from_secs(20));
+
+        sessions.set_volume(0.25).await.unwrap();
+        sessions.set_repeat_mode(RepeatMode::All).await.unwrap();
+        sessions.set_shuffle(true).await.unwrap();
+        assert_eq!(player.volume(), 0.25);
+        assert_eq!(player.repeat_mode(), RepeatMode::All);
+        assert!(player.shuffle());
+    }
+
+    /// Tests that player signals turn into events.
+    #[tokio::test]
+    async fn test_mpris_events() {
+        let (_bus, player, sessions) =
+            setup(MediaSessions::builder().debounce_duration(Duration::from_millis(10))).await;
+        let mut stream = Box::pin(sessions.watch().await.unwrap());
+
+        player.set_metadata(track("Next Track")).await.unwrap();
+        let event = next_matching(&mut stream, |event| {
+            matches!(event, MediaSessionEvent::MetadataChanged(_))
+        })
+        .await;
+        let MediaSessionEvent::MetadataChanged(info) = event else {
+            unreachable!();
+        };
+        assert_eq!(info.title.as_deref(), Some("Next Track"));
+
+        player.seeked(Duration::from_secs(60)).await.unwrap();
+        let event = next_matching(&mut stream, |event| {
+            matches!(event, MediaSessionEvent::PositionChanged { .. })
+        })
+        .await;
+        assert!(matches!(
+            event,
+            MediaSessionEvent::PositionChanged { position, .. }
+                if position == Duration::from_secs(60)
+        ));
+    }
+
+    /// Tests that the next player takes over when the active one quits.
+    #[tokio::test]
+    async fn test_mpris_players_come_and_go() {
+        let (bus, player, sessions) = setup(MediaSessions::builder()).await;
+        let second = bus.spawn_player("second", track("Other")).await.unwrap();
+        assert_eq!(
+            sessions.active_app().await.unwrap().as_deref(),
+            Some("fake")
+        );
+
+        player.quit().await.unwrap();
+        let active = tokio::time::timeout(Duration::from_secs(2), async {
+            loop {
+                let active = sessions.active_app().await.unwrap();
+                if active.as_deref() != Some("fake") {
+                    return active;
+                }
+                tokio::time::sleep(Duration::from_millis(10)).await;
+            }
+        })
+        .await
+        .expect("active player did not change");
+        assert_eq!(active.as_deref(), Some("second"));
+
+        let info = sessions.current().await.unwrap().unwrap();
+        assert_eq!(info.title.as_deref(), Some("Other"));
+        drop(second);
+    }
+
+    /// Tests that a slow player gets only the latest volume of a drag.
+    #[tokio::test]
+    async fn test_mpris_combine_writes() {
+        let (_bus, player, sessions) = setup(MediaSessions::builder().combine_writes(true)).await;
+        player.set_delay(Duration::from_millis(50));
+
+        // The player starts at full volume, which the drag never returns to.
+        let drag = (1..=9).map(|step| sessions.set_volume(f64::from(step) / 10.0));
+        for result in futures::future::join_all(drag).await {
+            result.unwrap();
+        }
+
+        assert_eq!(player.calls("Volume"), 2);
+        assert_eq!(player.volume(), 0.9);
+    }
+}